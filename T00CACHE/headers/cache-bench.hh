@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef CACHE_BENCH_HH_INCL
+#define CACHE_BENCH_HH_INCL
+
+#include "cache-gen.hh"
+
+namespace caches
+{
+
+// Benchmarks results are printed in stdout.
+
+// All cache policies on synthetic traces (Zipf, scans, loops, shifting
+// working set) and on recorded traces from given files (binary or text).
+//     One json line per (policy, trace) run: hit rate, ns/op,
+//     p50/p99/p999 latencies and peak resident memory.
+void benchPolicies( int tracesNum, char ** traceFilenames );
+
+// ShardedCache2Q vs Cache2Q under one global mutex:
+//     lookups/sec on Zipf distributed requests
+//     for 1 .. hardware_concurrency threads.
+void benchShardedThroughput();
+
+// ConcurrentCacheLRU vs ShardedCache2Q vs LRU under one mutex on
+// hot set fitting in cache: lookups/sec for 1 .. hardware_concurrency threads.
+void benchReadMostly();
+
+// Slow backend loads under shard lock vs without lock vs with AsyncLoader:
+//     backend calls number & requests latency percentiles.
+//     AsyncLoader run metrics are dumped to stderr as json lines.
+void benchAsyncLoader();
+
+// getElems batches vs per element getElem loop for LRU & 2Q caches
+// bigger than last level cache: ns per lookup & speedup.
+void benchBatchLookup();
+
+// CacheLRU with load time checked on each hit vs CacheTtlLRU
+// with CoarseClock: ns per lookup & hit rate.
+void benchTtlLookup();
+
+// Cache2Q vs TieredCache2Q with disk tier in temp directory on trace
+// with 16x more keys than memory capacity: hits in each tier,
+// backend loads number & ns per lookup.
+void benchTieredCache();
+
+} // namespace caches
+
+#endif // #ifndef CACHE_BENCH_HH_INCL
@@ -0,0 +1,247 @@
+#ifndef CACHE_CONCURRENT_IMPL_HH_INCL
+#define CACHE_CONCURRENT_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T, typename T_id>
+ConcurrentCacheLRU<T, T_id>::Reader::Reader( ConcurrentCacheLRU * cache, EpochSlot * slot ) :
+    cache_ (cache),
+    slot_ (slot)
+{
+    assert (cache_ != nullptr && slot_ != nullptr);
+}
+
+template <typename T, typename T_id>
+ConcurrentCacheLRU<T, T_id>::Reader::~Reader()
+{
+    slot_->isUsed_.store (false, std::memory_order_release);
+}
+
+template <typename T, typename T_id>
+T ConcurrentCacheLRU<T, T_id>::Reader::getElem( T_id id )
+{
+    // Epoch is published before chains are read: reclaim either sees
+    // this reader or this reader does not see unlinked nodes.
+    slot_->epoch_.store (cache_->globalEpoch_.load (std::memory_order_acquire), std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    Node * node = cache_->find (id);
+    if (node == nullptr)
+    {
+        slot_->epoch_.store (0, std::memory_order_release);
+        return cache_->load (id);
+    }
+
+    T elem = node->elem_;
+    slot_->epoch_.store (0, std::memory_order_release);
+
+    hits_[hitsNum_++] = id;
+    if (hitsNum_ == READ_BUFFER_SIZE_)
+    {
+        cache_->applyHits (hits_.data (), hitsNum_);
+        hitsNum_ = 0;
+    }
+
+    return elem;
+}
+
+template <typename T, typename T_id>
+bool ConcurrentCacheLRU<T, T_id>::Reader::isCached( T_id id )
+{
+    slot_->epoch_.store (cache_->globalEpoch_.load (std::memory_order_acquire), std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    bool isFound = cache_->find (id) != nullptr;
+    slot_->epoch_.store (0, std::memory_order_release);
+
+    return isFound;
+}
+
+template <typename T, typename T_id>
+ConcurrentCacheLRU<T, T_id>::ConcurrentCacheLRU( size_t capacity ) :
+    capacity_ (std::max<size_t> (capacity, MIN_CAPACITY_))
+{
+    size_t bucketsNum = 2;
+    while (bucketsNum < capacity_)
+        bucketsNum *= 2;
+
+    buckets_ = std::vector<std::atomic<Node *>> (bucketsNum);
+    mask_ = bucketsNum - 1;
+
+    retired_.reserve (MAX_RETIRED_);
+}
+
+template <typename T, typename T_id>
+ConcurrentCacheLRU<T, T_id>::~ConcurrentCacheLRU()
+{
+    while (head_ != nullptr)
+    {
+        Node * next = head_->next_;
+        delete head_;
+        head_ = next;
+    }
+
+    for (Retired& retired : retired_)
+        delete retired.node_;
+}
+
+template <typename T, typename T_id>
+std::unique_ptr<typename ConcurrentCacheLRU<T, T_id>::Reader> ConcurrentCacheLRU<T, T_id>::getReader()
+{
+    for (EpochSlot& slot : epochSlots_)
+    {
+        bool isUsed = false;
+        if (slot.isUsed_.compare_exchange_strong (isUsed, true, std::memory_order_acquire))
+            return std::make_unique<Reader> (this, &slot);
+    }
+
+    return nullptr;
+}
+
+template <typename T, typename T_id>
+size_t ConcurrentCacheLRU<T, T_id>::size()
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return size_;
+}
+
+template <typename T, typename T_id>
+size_t ConcurrentCacheLRU<T, T_id>::getBucket( T_id id ) const
+{
+    std::uint64_t hash = std::hash<T_id> {} (id);
+    hash *= 0x9E3779B97F4A7C15ull;
+
+    return (hash ^ (hash >> 32)) & mask_;
+}
+
+template <typename T, typename T_id>
+typename ConcurrentCacheLRU<T, T_id>::Node * ConcurrentCacheLRU<T, T_id>::find( T_id id ) const
+{
+    Node * node = buckets_[getBucket (id)].load (std::memory_order_acquire);
+
+    while (node != nullptr && node->id_ != id)
+        node = node->chainNext_.load (std::memory_order_acquire);
+
+    return node;
+}
+
+template <typename T, typename T_id>
+void ConcurrentCacheLRU<T, T_id>::link2Front( Node * node )
+{
+    node->prev_ = nullptr;
+    node->next_ = head_;
+
+    if (head_ != nullptr)
+        head_->prev_ = node;
+    else
+        tail_ = node;
+
+    head_ = node;
+}
+
+template <typename T, typename T_id>
+void ConcurrentCacheLRU<T, T_id>::unlink( Node * node )
+{
+    if (node->prev_ != nullptr)
+        node->prev_->next_ = node->next_;
+    else
+        head_ = node->next_;
+
+    if (node->next_ != nullptr)
+        node->next_->prev_ = node->prev_;
+    else
+        tail_ = node->prev_;
+}
+
+template <typename T, typename T_id>
+void ConcurrentCacheLRU<T, T_id>::evict()
+{
+    Node * victim = tail_;
+    unlink (victim);
+    --size_;
+
+    // Readers at victim go on with its chainNext_, it is not changed.
+    std::atomic<Node *> * link = &buckets_[getBucket (victim->id_)];
+    while (link->load (std::memory_order_relaxed) != victim)
+        link = &link->load (std::memory_order_relaxed)->chainNext_;
+    link->store (victim->chainNext_.load (std::memory_order_relaxed), std::memory_order_release);
+
+    // Readers entered after epoch increment cannot see victim.
+    retired_.push_back ({victim, globalEpoch_.fetch_add (1, std::memory_order_seq_cst)});
+
+    if (retired_.size () >= MAX_RETIRED_)
+        reclaim ();
+}
+
+template <typename T, typename T_id>
+void ConcurrentCacheLRU<T, T_id>::reclaim()
+{
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    // Min epoch of readers in read section.
+    std::uint64_t minEpoch = ~std::uint64_t {0};
+    for (const EpochSlot& slot : epochSlots_)
+    {
+        std::uint64_t epoch = slot.epoch_.load (std::memory_order_acquire);
+        if (epoch != 0)
+            minEpoch = std::min (minEpoch, epoch);
+    }
+
+    auto freedEnd = std::partition (retired_.begin (), retired_.end (), [minEpoch]( const Retired& retired )
+        { return retired.epoch_ >= minEpoch; });
+
+    for (auto it = freedEnd; it != retired_.end (); ++it)
+        delete it->node_;
+    retired_.erase (freedEnd, retired_.end ());
+}
+
+template <typename T, typename T_id>
+void ConcurrentCacheLRU<T, T_id>::applyHits( const T_id * ids, size_t idsNum )
+{
+    std::unique_lock<std::mutex> lock {mutex_, std::try_to_lock};
+    if (!lock.owns_lock ())
+        return;
+
+    for (size_t i = 0; i < idsNum; ++i)
+    {
+        // Element could be evicted after hit.
+        Node * node = find (ids[i]);
+        if (node != nullptr && node != head_)
+        {
+            unlink (node);
+            link2Front (node);
+        }
+    }
+}
+
+template <typename T, typename T_id>
+T ConcurrentCacheLRU<T, T_id>::load( T_id id )
+{
+    // Element is loaded without lock, concurrent loads of one id are possible.
+    Node * loaded = new Node (id, id);
+
+    std::lock_guard<std::mutex> lock {mutex_};
+
+    if (Node * node = find (id))
+    {
+        delete loaded;
+        return node->elem_;
+    }
+
+    if (size_ == capacity_)
+        evict ();
+
+    std::atomic<Node *>& bucket = buckets_[getBucket (id)];
+    loaded->chainNext_.store (bucket.load (std::memory_order_relaxed), std::memory_order_relaxed);
+    bucket.store (loaded, std::memory_order_release);
+
+    link2Front (loaded);
+    ++size_;
+
+    return loaded->elem_;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_CONCURRENT_IMPL_HH_INCL
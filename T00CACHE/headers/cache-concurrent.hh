@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef CACHE_CONCURRENT_HH_INCL
+#define CACHE_CONCURRENT_HH_INCL
+
+#include "cache.hh"
+
+namespace caches {
+
+// Thread safe LRU cache for read mostly workloads.
+// Hits take no locks & write nothing shared: hash chains are read under
+// epoch protection (nodes removed from chains are freed only when all
+// readers that could see them are gone) & element is copied out.
+// Recency of hits is recorded in reader's own buffer & applied to LRU
+// list in batches by the thread that gets maintenance lock, like
+// read buffers of Caffeine. If lock is busy, batch is dropped: it only
+// makes LRU order less precise.
+// Misses, insertions & evictions are done under maintenance lock.
+template <typename T, typename T_id>
+class ConcurrentCacheLRU
+{
+    struct Node
+    {
+        T elem_;
+        T_id id_;
+        std::atomic<Node *> chainNext_ {nullptr};
+        // LRU list links, used under lock only.
+        Node * prev_ = nullptr;
+        Node * next_ = nullptr;
+
+        template <typename... Args>
+        Node( T_id id, Args&&... args ) : elem_ (std::forward<Args> (args)...), id_ (id) {}
+    };
+
+    // Reader's epoch slot, one cache line for each.
+    struct alignas (64) EpochSlot
+    {
+        // Global epoch seen by reader in read section, 0 out of it.
+        std::atomic<std::uint64_t> epoch_ {0};
+        std::atomic<bool> isUsed_ {false};
+    };
+
+    struct Retired
+    {
+        Node * node_;
+        std::uint64_t epoch_;
+    };
+
+    static constexpr size_t MAX_READERS_ = 256;
+    // Hits number buffered by reader before applying them to LRU list.
+    static constexpr size_t READ_BUFFER_SIZE_ = 64;
+    // Retired nodes number to try to free them.
+    static constexpr size_t MAX_RETIRED_ = 64;
+
+    // Max cached elems num.
+    const size_t capacity_;
+    // Min capacity_ value.
+    static constexpr size_t MIN_CAPACITY_ = 1;
+
+    std::vector<std::atomic<Node *>> buckets_;
+    // buckets_.size () - 1.
+    size_t mask_ = 0;
+
+    std::array<EpochSlot, MAX_READERS_> epochSlots_;
+    // Starts from 1, 0 means "not reading".
+    std::atomic<std::uint64_t> globalEpoch_ {1};
+
+    // Protects everything below & chains modification.
+    std::mutex mutex_;
+    size_t size_ = 0;
+    // The most recently used node.
+    Node * head_ = nullptr;
+    Node * tail_ = nullptr;
+    // Nodes removed from chains, but possibly seen by readers.
+    std::vector<Retired> retired_;
+
+    size_t getBucket( T_id ) const;
+    // Chain search, called in read section or under lock.
+    Node * find( T_id ) const;
+
+    // LRU list operations, under lock.
+    void link2Front( Node * );
+    void unlink( Node * );
+
+    // Removes LRU node from chain & list, under lock.
+    void evict();
+    // Frees retired nodes not seen by any reader, under lock.
+    void reclaim();
+
+    // Applies buffered hits to LRU list if lock is free.
+    void applyHits( const T_id * ids, size_t idsNum );
+    // Miss path: loads element & inserts it under lock.
+    T load( T_id );
+
+public:
+
+    // Thread's handle for cache lookups. Each thread should use its own
+    // reader, reader should not outlive cache.
+    class Reader
+    {
+        ConcurrentCacheLRU * cache_;
+        EpochSlot * slot_;
+
+        std::array<T_id, READ_BUFFER_SIZE_> hits_;
+        size_t hitsNum_ = 0;
+
+    public:
+
+        Reader( ConcurrentCacheLRU * cache, EpochSlot * slot );
+
+       ~Reader();
+        Reader( const Reader& ) = delete;
+        Reader( Reader&& ) = delete;
+        Reader& operator=( const Reader& ) = delete;
+        Reader& operator=( Reader&& ) = delete;
+
+        // Searches element by it's id, loads missed one.
+        // Returns element copy.
+        T getElem( T_id );
+        // To check if element cached.
+        bool isCached( T_id );
+    };
+
+    ConcurrentCacheLRU( size_t capacity );
+
+   ~ConcurrentCacheLRU();
+    ConcurrentCacheLRU( const ConcurrentCacheLRU& ) = delete;
+    ConcurrentCacheLRU( ConcurrentCacheLRU&& ) = delete;
+    ConcurrentCacheLRU& operator=( const ConcurrentCacheLRU& ) = delete;
+    ConcurrentCacheLRU& operator=( ConcurrentCacheLRU&& ) = delete;
+
+    // Returns nullptr if all MAX_READERS_ readers are in use.
+    std::unique_ptr<Reader> getReader();
+
+    size_t size();
+};
+
+} // namespace caches
+
+#include "cache-concurrent-impl.hh"
+
+#endif // #ifndef CACHE_CONCURRENT_HH_INCL
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#ifndef CACHE_GEN_HH_INCL
+#define CACHE_GEN_HH_INCL
+
+#include "cache-tests.hh"
+
+namespace caches
+{
+
+// Uniform double from [0, 1) made of 53 high bits of rng output.
+// std::uniform_real_distribution algorithm is implementation defined,
+// so traces generated with it differ between standard libraries.
+inline double genUniform( std::mt19937_64& rng )
+{
+    return (rng () >> 11) * 0x1.0p-53;
+}
+
+// Generates ids with Zipf distribution: id k from [0, keysNum)
+// is generated with probability ~ 1 / (k + 1)^skew.
+class ZipfGen
+{
+    // Cumulative distribution function values.
+    std::vector<double> cdf_;
+    std::mt19937_64 rng_;
+
+public:
+
+    ZipfGen( size_t keysNum, double skew, std::uint64_t seed ) :
+        cdf_ (std::max<size_t> (keysNum, 1)),
+        rng_ (seed)
+    {
+        double sum = 0;
+        for (size_t k = 0; k < cdf_.size (); ++k)
+            cdf_[k] = sum += 1 / std::pow (k + 1, skew);
+
+        for (double& val : cdf_)
+            val /= sum;
+    }
+
+    testPageId_t operator()()
+    {
+        double toFind = genUniform (rng_);
+        auto cdfIt = std::lower_bound (cdf_.begin (), cdf_.end (), toFind);
+
+        return std::min<size_t> (cdfIt - cdf_.begin (), cdf_.size () - 1);
+    }
+};
+
+inline std::vector<testPageId_t> genZipfTrace( size_t size, size_t keysNum, double skew, std::uint64_t seed )
+{
+    ZipfGen gen {keysNum, skew, seed};
+    std::vector<testPageId_t> trace (size);
+
+    for (testPageId_t& id : trace)
+        id = gen ();
+
+    return trace;
+}
+
+// Zipf distributed requests mixed with scans: every scanPeriod requests
+// scanLen ids that are never requested again are requested one by one.
+inline std::vector<testPageId_t> genScanTrace( size_t size, size_t keysNum, double skew,
+                                               size_t scanPeriod, size_t scanLen, std::uint64_t seed )
+{
+    ZipfGen gen {keysNum, skew, seed};
+    std::vector<testPageId_t> trace (size);
+    // Scanned ids are placed after Zipf ones.
+    testPageId_t scanId = keysNum;
+
+    for (size_t i = 0; i < size; ++i)
+        trace[i] = i % (scanPeriod + scanLen) < scanPeriod ? gen () : scanId++;
+
+    return trace;
+}
+
+// Ids [0, loopLen) are requested cyclically.
+inline std::vector<testPageId_t> genLoopTrace( size_t size, size_t loopLen )
+{
+    std::vector<testPageId_t> trace (size);
+
+    for (size_t i = 0; i < size; ++i)
+        trace[i] = i % std::max<size_t> (loopLen, 1);
+
+    return trace;
+}
+
+// Zipf distributed requests, but working set is changed phasesNum times:
+// each phase requests its own keysNum ids.
+inline std::vector<testPageId_t> genShiftingTrace( size_t size, size_t keysNum, double skew,
+                                                   size_t phasesNum, std::uint64_t seed )
+{
+    ZipfGen gen {keysNum, skew, seed};
+    std::vector<testPageId_t> trace (size);
+    size_t phaseLen = std::max<size_t> (size / std::max<size_t> (phasesNum, 1), 1);
+
+    for (size_t i = 0; i < size; ++i)
+        trace[i] = gen () + (i / phaseLen) * keysNum;
+
+    return trace;
+}
+
+// Replays popularity of recorded trace: each id of ids is generated with
+// probability equal to its share of requests in ids. Empty for empty ids.
+inline std::vector<testPageId_t> genReplayTrace( const testPageId_t * ids, size_t idsNum,
+                                                 size_t size, std::uint64_t seed )
+{
+    assert (ids != nullptr || idsNum == 0);
+
+    // Distinct ids in order of the first request & their requests numbers.
+    std::vector<testPageId_t> keys {};
+    std::vector<double> cdf {};
+    std::unordered_map<testPageId_t, size_t> keyPos {};
+
+    for (size_t i = 0; i < idsNum; ++i)
+    {
+        auto [posIt, isNew] = keyPos.try_emplace (ids[i], keys.size ());
+        if (isNew)
+        {
+            keys.push_back (ids[i]);
+            cdf.push_back (0);
+        }
+        ++cdf[posIt->second];
+    }
+
+    std::vector<testPageId_t> trace (keys.empty () ? 0 : size);
+    std::partial_sum (cdf.begin (), cdf.end (), cdf.begin ());
+    for (double& val : cdf)
+        val /= idsNum;
+
+    std::mt19937_64 rng {seed};
+
+    for (testPageId_t& id : trace)
+    {
+        auto cdfIt = std::lower_bound (cdf.begin (), cdf.end (), genUniform (rng));
+        id = keys[std::min<size_t> (cdfIt - cdf.begin (), keys.size () - 1)];
+    }
+
+    return trace;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_GEN_HH_INCL
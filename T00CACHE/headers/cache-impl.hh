@@ -6,136 +6,537 @@ namespace caches
 {
 
 template <typename T, typename T_id>
-CacheLRU<T, T_id>::CacheLRU( size_t capacity ) :
-    capacity_(std::max<size_t> (capacity, MIN_CAPACITY_))
+CacheAdaptive2Q<T, T_id>::CacheAdaptive2Q( size_t capacity ) :
+    amCapacity_ (std::max<size_t>
+        (std::trunc (INIT_AM_QUOTA_ * capacity), MIN_AM_CAPACITY_)),
+    alinCapacity_ (std::max<size_t>
+        (std::trunc (INIT_ALIN_QUOTA_ * capacity), MIN_ALIN_CAPACITY_)),
+    aloutCapacity_ (std::max<size_t>
+        (capacity > amCapacity_ + alinCapacity_ ? capacity - amCapacity_ - alinCapacity_ : 0,
+         MIN_ALOUT_CAPACITY_)),
+    storage_ (amCapacity_ + alinCapacity_ + aloutCapacity_),
+    amGhosts_ (amCapacity_ + alinCapacity_)
 {}
 
 template <typename T, typename T_id>
-T CacheLRU<T, T_id>::getElem( T_id id )
+const T& CacheAdaptive2Q<T, T_id>::getElem( T_id id )
 {
-    auto hashIt = hashTable_.find (id);
+    slot_t amSlot = storage_.find (AM, id);
+    if (amSlot != NIL_SLOT)
+    {
+        metrics_.add (CacheMetrics::AM_HITS);
+
+        storage_.move2Front (AM, amSlot);
+        return storage_.elem (amSlot);
+    }
 
-    if (hashIt == hashTable_.end ()) // Not cached element.
+    slot_t aloutSlot = storage_.find (ALOUT, id);
+    // Move element form alout to the head of am.
+    if (aloutSlot != NIL_SLOT)
     {
-        if (cachedElemsNum_ >= capacity_)
-        {
-            hashTable_.erase (elemsList_.back ().second);
-            elemsList_.pop_back ();
+        metrics_.add (CacheMetrics::ALOUT_HITS);
+        metrics_.add (CacheMetrics::PROMOTIONS);
+
+        ++aloutHitsNum_;
+        growAlin ();
+
+        storage_.splice2Front (ALOUT, aloutSlot, AM);
+        while (storage_.size (AM) > amCapacity_)
+            evictAm ();
+
+        return storage_.elem (aloutSlot);
+    }
+
+    slot_t alinSlot = storage_.find (ALIN, id);
+    // Do nothing.
+    if (alinSlot != NIL_SLOT)
+    {
+        metrics_.add (CacheMetrics::ALIN_HITS);
+        return storage_.elem (alinSlot);
+    }
+
+    metrics_.add (CacheMetrics::MISSES);
+
+    // Element was evicted from am not long ago => load element to the head of am.
+    slot_t ghostSlot = amGhosts_.find (0, id);
+    if (ghostSlot != NIL_SLOT)
+    {
+        ++amGhostHitsNum_;
+        growAm ();
+        amGhosts_.erase (0, ghostSlot);
+
+        while (storage_.size (AM) >= amCapacity_)
+            evictAm ();
+        if (storage_.isFull ())
+            freeSlot ();
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+        const T& loaded = storage_.elem (storage_.emplaceFront (AM, id, id));
+        metrics_.addLoadTime (std::chrono::steady_clock::now () - begin);
+
+        return loaded;
+    }
 
-            --cachedElemsNum_;
+    // Element isn't cached => load element to the head of alin.
+    while (storage_.size (ALIN) >= alinCapacity_)
+    {
+        if (storage_.size (ALOUT) >= aloutCapacity_)
+        {
+            metrics_.add (CacheMetrics::EVICTIONS);
+            storage_.erase (ALOUT, storage_.back (ALOUT));
         }
 
-        T elem {id};
+        storage_.splice2Front (ALIN, storage_.back (ALIN), ALOUT);
+    }
+    if (storage_.isFull ())
+        freeSlot ();
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+    const T& loaded = storage_.elem (storage_.emplaceFront (ALIN, id, id));
+    metrics_.addLoadTime (std::chrono::steady_clock::now () - begin);
+
+    return loaded;
+}
+
+template <typename T, typename T_id>
+void CacheAdaptive2Q<T, T_id>::evictAm()
+{
+    metrics_.add (CacheMetrics::EVICTIONS);
 
-        elemsList_.push_front (EnId<T, T_id> {elem, id});
-        hashTable_ [id] = elemsList_.begin ();
+    slot_t victim = storage_.back (AM);
+    T_id victimId = storage_.id (victim);
+    storage_.erase (AM, victim);
 
-        ++cachedElemsNum_;
+    if (amGhosts_.isFull ())
+        amGhosts_.erase (0, amGhosts_.back (0));
+    amGhosts_.emplaceFront (0, victimId);
+}
 
-        return elem;
+template <typename T, typename T_id>
+void CacheAdaptive2Q<T, T_id>::freeSlot()
+{
+    // Storage is full => am is over its capacity after tuning or alout is not empty.
+    if (storage_.size (AM) > amCapacity_ || storage_.size (ALOUT) == 0)
+        evictAm ();
+    else
+    {
+        metrics_.add (CacheMetrics::EVICTIONS);
+        storage_.erase (ALOUT, storage_.back (ALOUT));
     }
+}
+
+template <typename T, typename T_id>
+void CacheAdaptive2Q<T, T_id>::growAlin()
+{
+    size_t delta = std::max<size_t> (amGhosts_.size (0) / std::max<size_t> (storage_.size (ALOUT), 1), 1);
+    size_t total = amCapacity_ + alinCapacity_;
+
+    alinCapacity_ = std::min (alinCapacity_ + delta, total - MIN_AM_CAPACITY_);
+    amCapacity_ = total - alinCapacity_;
+}
+
+template <typename T, typename T_id>
+void CacheAdaptive2Q<T, T_id>::growAm()
+{
+    size_t delta = std::max<size_t> (storage_.size (ALOUT) / std::max<size_t> (amGhosts_.size (0), 1), 1);
+    size_t total = amCapacity_ + alinCapacity_;
+
+    amCapacity_ = std::min (amCapacity_ + delta, total - MIN_ALIN_CAPACITY_);
+    alinCapacity_ = total - amCapacity_;
+}
+
+template <typename T, typename T_id>
+typename CacheAdaptive2Q<T, T_id>::Stats CacheAdaptive2Q<T, T_id>::getStats() const
+{
+    Stats stats {};
+
+    stats.amCapacity_ = amCapacity_;
+    stats.alinCapacity_ = alinCapacity_;
+    stats.aloutCapacity_ = aloutCapacity_;
+
+    stats.amSize_ = storage_.size (AM);
+    stats.alinSize_ = storage_.size (ALIN);
+    stats.aloutSize_ = storage_.size (ALOUT);
+    stats.amGhostsSize_ = amGhosts_.size (0);
+
+    stats.aloutHitsNum_ = aloutHitsNum_;
+    stats.amGhostHitsNum_ = amGhostHitsNum_;
+
+    return stats;
+}
+
+template <typename T, typename T_id>
+CacheMetrics::Snapshot CacheAdaptive2Q<T, T_id>::getMetrics() const
+{
+    return metrics_.read ();
+}
+
+template <typename T, typename T_id>
+ShardedCache2Q<T, T_id>::Shard::Shard( size_t capacity ) :
+    cache_ (capacity)
+{}
+
+template <typename T, typename T_id>
+ShardedCache2Q<T, T_id>::ShardedCache2Q( size_t capacity, size_t shardsNum )
+{
+    if (shardsNum == 0)
+        shardsNum = std::max<size_t> (std::thread::hardware_concurrency (), 1);
+
+    capacity = std::max<size_t> (capacity, Cache2Q<T, T_id>::MIN_CAPACITY_);
+    shardsNum = std::min<size_t> (shardsNum, capacity / Cache2Q<T, T_id>::MIN_CAPACITY_);
+
+    shards_.reserve (shardsNum);
+    for (size_t i = 0; i < shardsNum; ++i)
+        shards_.push_back (std::make_unique<Shard>
+            (capacity / shardsNum + (i < capacity % shardsNum)));
+}
+
+template <typename T, typename T_id>
+size_t ShardedCache2Q<T, T_id>::getShardsNum() const
+{
+    return shards_.size ();
+}
+
+template <typename T, typename T_id>
+size_t ShardedCache2Q<T, T_id>::getShardId( T_id id ) const
+{
+    // Multiplier differs from FlatIndex one to keep shard & bucket choice independent.
+    std::uint64_t hash = std::hash<T_id> {} (id);
+    hash *= 0xC2B2AE3D27D4EB4Full;
+
+    return (hash >> 32) % shards_.size ();
+}
+
+template <typename T, typename T_id>
+T ShardedCache2Q<T, T_id>::getElem( T_id id )
+{
+    Shard& shard = *shards_[getShardId (id)];
+    std::lock_guard<std::mutex> lock {shard.mutex_};
+
+    return shard.cache_.getElem (id);
+}
 
-    elemsList_.splice (elemsList_.begin (), elemsList_, hashIt->second);
+template <typename T, typename T_id>
+std::optional<T> ShardedCache2Q<T, T_id>::findElem( T_id id )
+{
+    Shard& shard = *shards_[getShardId (id)];
+    std::lock_guard<std::mutex> lock {shard.mutex_};
+
+    if (const T * cached = shard.cache_.findElem (id))
+        return *cached;
+
+    return std::nullopt;
+}
+
+template <typename T, typename T_id>
+void ShardedCache2Q<T, T_id>::addLoaded( T_id id, T elem )
+{
+    Shard& shard = *shards_[getShardId (id)];
+    std::lock_guard<std::mutex> lock {shard.mutex_};
 
-    return elemsList_.front ().first;
+    shard.cache_.addLoaded (id, std::move (elem));
 }
 
 template <typename T, typename T_id>
-void CacheLRU<T, T_id>::addElem( EnId<T, T_id> pair )
+std::shared_future<T> ShardedCache2Q<T, T_id>::getElemAsync( T_id id, AsyncLoader<T, T_id>& loader )
 {
-    if (isCached (pair.second)) // Remove old value.
+    Shard& shard = *shards_[getShardId (id)];
+    std::lock_guard<std::mutex> lock {shard.mutex_};
+
+    if (const T * cached = shard.cache_.findElem (id))
     {
-        auto hashIt = hashTable_.find (pair.second);
-        auto oldPairListIt = hashIt->second;
-        hashTable_.erase (oldPairListIt->second);
-        elemsList_.erase (oldPairListIt);
+        std::promise<T> ready {};
+        ready.set_value (*cached);
+        return ready.get_future ().share ();
     }
 
-    else if (cachedElemsNum_ >= capacity_) // Free space.
+    // Load is started under shard lock: loaded element is added to cache
+    // before load is finished, so there is no window for second load.
+    // Load time includes time in loader queue.
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+
+    return loader.load (id, [&shard, begin]( T_id loadedId, const T& elem )
     {
-        hashTable_.erase (elemsList_.back ().second);
-        elemsList_.pop_back ();
+        std::lock_guard<std::mutex> loadedLock {shard.mutex_};
+        shard.cache_.addLoaded (loadedId, elem);
+        shard.cache_.addLoadTime (std::chrono::steady_clock::now () - begin);
+    });
+}
+
+template <typename T, typename T_id>
+CacheMetrics::Snapshot ShardedCache2Q<T, T_id>::getMetrics() const
+{
+    CacheMetrics::Snapshot sum {};
+
+    for (const std::unique_ptr<Shard>& shard : shards_)
+        mergeSnapshot (sum, shard->cache_.getMetrics ());
+
+    return sum;
+}
+
+template <typename T, typename T_id>
+CacheClockPro<T, T_id>::CacheClockPro( size_t capacity ) :
+    capacity_ (std::max<size_t> (capacity, MIN_CAPACITY_)),
+    maxColdCapacity_ (std::max<size_t> (std::trunc (MAX_COLD_QUOTA_ * capacity_), 1)),
+    coldCapacity_ (maxColdCapacity_),
+    entries_ (2 * capacity_ + 1),
+    index_ (2 * capacity_ + 1)
+{
+    for (slot_t slot = 0; slot < entries_.size (); ++slot)
+        entries_[slot].next_ = slot + 1 == entries_.size () ? NIL_SLOT : slot + 1;
+    freeHead_ = 0;
+}
+
+template <typename T, typename T_id>
+const T& CacheClockPro<T, T_id>::getElem( T_id id )
+{
+    slot_t slot = index_.find (id);
+
+    if (slot != NIL_SLOT && entries_[slot].status_ != Status::TEST) // Cached element.
+    {
+        metrics_.add (CacheMetrics::HITS);
+
+        entries_[slot].ref_ = true;
+        return *entries_[slot].elem_;
+    }
+
+    metrics_.add (CacheMetrics::MISSES);
+    Status status = Status::COLD;
+
+    // Element was evicted in its test period => it is hot,
+    // and cold elements need more space.
+    if (slot != NIL_SLOT)
+    {
+        coldCapacity_ = std::min (coldCapacity_ + 1, maxColdCapacity_);
+
+        delEntry (slot);
+        --testNum_;
+        status = Status::HOT;
     }
 
-    elemsList_.emplace_front (pair);
-    hashTable_[pair.second] = elemsList_.begin ();
+    evict ();
+    slot = addEntry (id, status);
+
+    if (status == Status::HOT)
+        ++hotNum_;
+    else
+        ++coldNum_;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+    const T& loaded = entries_[slot].elem_.emplace (id);
+    metrics_.addLoadTime (std::chrono::steady_clock::now () - begin);
+
+    return loaded;
 }
 
 template <typename T, typename T_id>
-bool CacheLRU<T, T_id>::isCached( T_id id ) const
+bool CacheClockPro<T, T_id>::isCached( T_id id ) const
 {
-    return hashTable_.find (id) != hashTable_.end ();
+    slot_t slot = index_.find (id);
+
+    return slot != NIL_SLOT && entries_[slot].status_ != Status::TEST;
 }
 
 template <typename T, typename T_id>
-Cache2Q<T, T_id>::Cache2Q( size_t capacity ) :
-    amCapacity_ (std::max<size_t>
-        (std::trunc (AM_QUOTA_ * capacity), MIN_AM_CAPACITY_)),
-    alinCapacity_ (std::max<size_t>
-        (std::trunc (ALIN_QUOTA_ * capacity), MIN_ALIN_CAPACITY_)),
-    aloutCapacity_ (std::max<size_t>
-        (capacity - amCapacity_ - alinCapacity_, MIN_ALOUT_CAPACITY_)),
-    am_ (amCapacity_)
-{}
+CacheMetrics::Snapshot CacheClockPro<T, T_id>::getMetrics() const
+{
+    return metrics_.read ();
+}
 
 template <typename T, typename T_id>
-T Cache2Q<T, T_id>::getElem( T_id id )
+slot_t CacheClockPro<T, T_id>::addEntry( T_id id, Status status )
 {
-    if (am_.isCached (id))
-        return am_.getElem (id);
+    assert (freeHead_ != NIL_SLOT);
 
-    auto aloutHashIt = aloutHashTable_.find (id);
-    // Move element form alout to the head of am.
-    if (aloutHashIt != aloutHashTable_.end ())
+    slot_t slot = freeHead_;
+    Entry& entry = entries_[slot];
+    freeHead_ = entry.next_;
+
+    entry.id_ = id;
+    entry.status_ = status;
+    entry.ref_ = false;
+    index_.insert (id, slot);
+
+    if (handHot_ == NIL_SLOT) // Empty ring.
     {
-        auto aloutIt = aloutHashIt->second;
+        entry.prev_ = entry.next_ = slot;
+        handHot_ = handCold_ = handTest_ = slot;
+        return slot;
+    }
+
+    slot_t prev = entries_[handHot_].prev_;
+    entry.prev_ = prev;
+    entry.next_ = handHot_;
+    entries_[prev].next_ = slot;
+    entries_[handHot_].prev_ = slot;
+
+    if (handCold_ == handHot_)
+        handCold_ = slot;
 
-        am_.addElem (*aloutIt);
+    return slot;
+}
+
+template <typename T, typename T_id>
+void CacheClockPro<T, T_id>::delEntry( slot_t slot )
+{
+    Entry& entry = entries_[slot];
+    index_.erase (entry.id_);
+
+    if (entry.next_ == slot) // The last entry in ring.
+        handHot_ = handCold_ = handTest_ = NIL_SLOT;
+    else
+    {
+        // Hands are moved back, so they will be moved to the next entry.
+        if (handHot_ == slot)
+            handHot_ = entry.prev_;
+        if (handCold_ == slot)
+            handCold_ = entry.prev_;
+        if (handTest_ == slot)
+            handTest_ = entry.prev_;
 
-        return aloutIt->first;
+        entries_[entry.prev_].next_ = entry.next_;
+        entries_[entry.next_].prev_ = entry.prev_;
     }
 
-    auto alinHashIt = alinHashTable_.find (id);
-    // Do nothing.
-    if (alinHashIt != alinHashTable_.end ())
-        return alinHashIt->second->first;
+    entry.elem_.reset ();
+    entry.prev_ = NIL_SLOT;
+    entry.next_ = freeHead_;
+    freeHead_ = slot;
+}
 
-    // Element isn't cached => load element to the head of alin.
-    return load2Cache (id);
+template <typename T, typename T_id>
+void CacheClockPro<T, T_id>::evict()
+{
+    while (hotNum_ + coldNum_ >= capacity_)
+        runHandCold ();
 }
 
 template <typename T, typename T_id>
-T Cache2Q<T, T_id>::load2Cache( T_id id )
+void CacheClockPro<T, T_id>::runHandCold()
 {
-    T elem {id};
+    Entry& entry = entries_[handCold_];
 
-    // Need to free space in alin.
-    if (alinCapacity_ <= alinCachedElemsNum_)
+    if (entry.status_ == Status::COLD)
     {
-        // Need to free space in alout.
-        if (aloutCapacity_ <= aloutCachedElemsNum_)
+        if (entry.ref_) // Accessed in test period => becomes hot.
         {
-            aloutHashTable_.erase (aloutList_.back ().second);
-            aloutList_.pop_back ();
-            --aloutCachedElemsNum_;
+            entry.status_ = Status::HOT;
+            entry.ref_ = false;
+            --coldNum_;
+            ++hotNum_;
         }
+        else // Evicted, but id is kept for test period.
+        {
+            metrics_.add (CacheMetrics::EVICTIONS);
+
+            entry.status_ = Status::TEST;
+            entry.elem_.reset ();
+            --coldNum_;
+            ++testNum_;
+
+            while (testNum_ > capacity_)
+                runHandTest ();
+        }
+    }
+
+    handCold_ = entries_[handCold_].next_;
+
+    while (hotNum_ > capacity_ - coldCapacity_)
+        runHandHot ();
+}
+
+template <typename T, typename T_id>
+void CacheClockPro<T, T_id>::runHandHot()
+{
+    Entry& entry = entries_[handHot_];
+
+    if (entry.status_ == Status::HOT)
+    {
+        if (entry.ref_)
+            entry.ref_ = false;
+        else // Not accessed for the whole clock round => becomes cold.
+        {
+            entry.status_ = Status::COLD;
+            --hotNum_;
+            ++coldNum_;
+        }
+    }
+
+    handHot_ = entries_[handHot_].next_;
+}
+
+template <typename T, typename T_id>
+void CacheClockPro<T, T_id>::runHandTest()
+{
+    // Test period is over without access => cold elements need less space.
+    if (entries_[handTest_].status_ == Status::TEST)
+    {
+        delEntry (handTest_);
+        --testNum_;
+
+        if (coldCapacity_ > 1)
+            --coldCapacity_;
+    }
+
+    handTest_ = entries_[handTest_].next_;
+}
+
+template <typename T, typename T_id>
+CacheBelady<T, T_id>::CacheBelady( size_t capacity, const T_id * seq, size_t seqSize ) :
+    capacity_ (std::max<size_t> (capacity, MIN_CAPACITY_)),
+    nextUse_ (seqSize, seqSize)
+{
+    assert (seq != nullptr || seqSize == 0);
+
+    std::unordered_map<T_id, size_t> lastSeen {};
+
+    for (size_t pos = seqSize; pos-- > 0;)
+    {
+        auto seenIt = lastSeen.find (seq[pos]);
+
+        if (seenIt != lastSeen.end ())
+        {
+            nextUse_[pos] = seenIt->second;
+            seenIt->second = pos;
+        }
+        else
+            lastSeen.emplace (seq[pos], pos);
+    }
+}
+
+template <typename T, typename T_id>
+const T& CacheBelady<T, T_id>::getElem( T_id id )
+{
+    assert (curPos_ < nextUse_.size ());
+    size_t nextUse = nextUse_[curPos_++];
+
+    auto hashIt = hashTable_.find (id);
+
+    if (hashIt != hashTable_.end ()) // Cached element.
+    {
+        nextUseOrder_.erase ({hashIt->second.second, id});
+        nextUseOrder_.emplace (nextUse, id);
+        hashIt->second.second = nextUse;
+
+        return hashIt->second.first;
+    }
+
+    if (hashTable_.size () >= capacity_)
+    {
+        auto victimIt = std::prev (nextUseOrder_.end ());
 
-        auto alinBack = alinList_.back ();
-        alinHashTable_.erase (alinBack.second);
-        alinList_.pop_back ();
-        --alinCachedElemsNum_;
+        // New element will be requested latest => no need to cache it.
+        if (victimIt->first <= nextUse)
+            return bypassed_.emplace (id);
 
-        aloutList_.emplace_front (alinBack);
-        aloutHashTable_[alinBack.second] = aloutList_.begin ();
-        ++aloutCachedElemsNum_;
+        hashTable_.erase (victimIt->second);
+        nextUseOrder_.erase (victimIt);
     }
 
-    // Placing new element in alin.
-    alinList_.emplace_front (EnId<T, T_id> {elem, id});
-    alinHashTable_[id] = alinList_.begin ();
-    ++alinCachedElemsNum_;
+    hashIt = hashTable_.emplace (id, std::pair<T, size_t> {T {id}, nextUse}).first;
+    nextUseOrder_.emplace (nextUse, id);
 
-    return elem;
+    return hashIt->second.first;
 }
 
 } // namespace caches
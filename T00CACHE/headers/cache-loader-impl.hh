@@ -0,0 +1,118 @@
+#ifndef CACHE_LOADER_IMPL_HH_INCL
+#define CACHE_LOADER_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T, typename T_id>
+AsyncLoader<T, T_id>::AsyncLoader( Backend backend, size_t workersNum ) :
+    backend_ (std::move (backend))
+{
+    workersNum = std::max<size_t> (workersNum, 1);
+
+    for (size_t i = 0; i < workersNum; ++i)
+        workers_.emplace_back (&AsyncLoader::work, this);
+}
+
+template <typename T, typename T_id>
+AsyncLoader<T, T_id>::~AsyncLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        stop_ = true;
+    }
+    hasQueued_.notify_all ();
+
+    for (std::thread& worker : workers_)
+        worker.join ();
+}
+
+template <typename T, typename T_id>
+std::shared_future<T> AsyncLoader<T, T_id>::load( T_id id, OnLoad onLoad )
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+
+    auto loadIt = inFlight_.find (id);
+    if (loadIt != inFlight_.end ())
+    {
+        ++coalescedNum_;
+        return loadIt->second.future_;
+    }
+
+    Load& load = inFlight_[id];
+    load.future_ = load.promise_.get_future ().share ();
+    load.onLoad_ = std::move (onLoad);
+    queue_.push_back (id);
+
+    hasQueued_.notify_one ();
+
+    return load.future_;
+}
+
+template <typename T, typename T_id>
+void AsyncLoader<T, T_id>::work()
+{
+    while (true)
+    {
+        T_id id {};
+        OnLoad onLoad {};
+        {
+            std::unique_lock<std::mutex> lock {mutex_};
+            hasQueued_.wait (lock, [this] { return stop_ || !queue_.empty (); });
+
+            // Queued loads are finished before stop.
+            if (queue_.empty ())
+                return;
+
+            id = queue_.front ();
+            queue_.pop_front ();
+            onLoad = inFlight_[id].onLoad_;
+        }
+
+        ++backendCallsNum_;
+
+        // Load stays in flight until onLoad is done, so new loads of
+        // this id are attached to it instead of calling backend again.
+        std::optional<T> elem {};
+        std::exception_ptr error {};
+        try
+        {
+            elem.emplace (backend_ (id));
+            if (onLoad)
+                onLoad (id, *elem);
+        }
+        catch (...)
+        {
+            error = std::current_exception ();
+        }
+
+        std::promise<T> promise {};
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            auto loadIt = inFlight_.find (id);
+            promise = std::move (loadIt->second.promise_);
+            inFlight_.erase (loadIt);
+        }
+
+        if (error)
+            promise.set_exception (error);
+        else
+            promise.set_value (std::move (*elem));
+    }
+}
+
+template <typename T, typename T_id>
+size_t AsyncLoader<T, T_id>::getBackendCallsNum() const
+{
+    return backendCallsNum_;
+}
+
+template <typename T, typename T_id>
+size_t AsyncLoader<T, T_id>::getCoalescedNum() const
+{
+    return coalescedNum_;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_LOADER_IMPL_HH_INCL
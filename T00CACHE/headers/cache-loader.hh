@@ -0,0 +1,79 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef CACHE_LOADER_HH_INCL
+#define CACHE_LOADER_HH_INCL
+
+namespace caches {
+
+// Loads elements from slow backend in worker threads.
+// Concurrent loads of the same id are coalesced:
+// the one backend call result is shared by all of them.
+template <typename T, typename T_id>
+class AsyncLoader
+{
+public:
+    // Slow elements source. Is called from worker threads.
+    using Backend = std::function<T( T_id )>;
+    // Is called from worker thread with loaded element before load future is ready.
+    using OnLoad = std::function<void( T_id, const T& )>;
+
+private:
+    struct Load
+    {
+        std::promise<T> promise_;
+        std::shared_future<T> future_;
+        OnLoad onLoad_;
+    };
+
+    Backend backend_;
+
+    std::mutex mutex_;
+    std::condition_variable hasQueued_;
+    // Loads that are queued or executed now.
+    std::unordered_map<T_id, Load> inFlight_;
+    std::deque<T_id> queue_;
+    bool stop_ = false;
+
+    std::atomic<size_t> backendCallsNum_ {0};
+    std::atomic<size_t> coalescedNum_ {0};
+
+    std::vector<std::thread> workers_;
+
+    void work();
+
+public:
+
+    // workersNum = max number of simultaneous backend calls.
+    AsyncLoader( Backend backend, size_t workersNum );
+
+    // Waits for all started loads.
+   ~AsyncLoader();
+    AsyncLoader( const AsyncLoader& ) = delete;
+    AsyncLoader( AsyncLoader&& ) = delete;
+    AsyncLoader& operator=( const AsyncLoader& ) = delete;
+    AsyncLoader& operator=( AsyncLoader&& ) = delete;
+
+    // Starts element load or attaches to started load of the same id.
+    // onLoad is called once per backend call, so onLoad of attached loads is ignored.
+    std::shared_future<T> load( T_id, OnLoad onLoad = {} );
+
+    size_t getBackendCallsNum() const;
+    // Number of loads attached to already started ones.
+    size_t getCoalescedNum() const;
+};
+
+} // namespace caches
+
+#include "cache-loader-impl.hh"
+
+#endif // #ifndef CACHE_LOADER_HH_INCL
@@ -0,0 +1,54 @@
+#ifndef CACHE_MAPPED_IMPL_HH_INCL
+#define CACHE_MAPPED_IMPL_HH_INCL
+
+namespace caches
+{
+
+inline MappedFile::MappedFile( const char * filename )
+{
+    assert (filename != nullptr);
+
+    int fd = open (filename, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat fileStat {};
+    if (fstat (fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        size_ = fileStat.st_size;
+        data_ = mmap (nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // Mapping is alive after fd close.
+    close (fd);
+
+    if (data_ == MAP_FAILED)
+        data_ = nullptr;
+
+    if (data_ != nullptr)
+        madvise (data_, size_, MADV_SEQUENTIAL);
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (data_ != nullptr)
+        munmap (data_, size_);
+}
+
+inline bool MappedFile::isValid() const
+{
+    return data_ != nullptr;
+}
+
+inline const unsigned char * MappedFile::data() const
+{
+    return static_cast<const unsigned char *> (data_);
+}
+
+inline size_t MappedFile::size() const
+{
+    return isValid () ? size_ : 0;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_MAPPED_IMPL_HH_INCL
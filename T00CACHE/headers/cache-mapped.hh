@@ -0,0 +1,39 @@
+#include <cassert>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef CACHE_MAPPED_HH_INCL
+#define CACHE_MAPPED_HH_INCL
+
+namespace caches {
+
+// Read only file mapped to memory, used for snapshots & binary traces.
+class MappedFile
+{
+    void * data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+
+    // File is invalid if it can't be mapped (e.g. it is empty).
+    MappedFile( const char * filename );
+
+   ~MappedFile();
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile( MappedFile&& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+    MappedFile& operator=( MappedFile&& ) = delete;
+
+    bool isValid() const;
+
+    const unsigned char * data() const;
+    size_t size() const;
+};
+
+} // namespace caches
+
+#include "cache-mapped-impl.hh"
+
+#endif // #ifndef CACHE_MAPPED_HH_INCL
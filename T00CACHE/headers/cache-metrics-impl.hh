@@ -0,0 +1,126 @@
+#ifndef CACHE_METRICS_IMPL_HH_INCL
+#define CACHE_METRICS_IMPL_HH_INCL
+
+namespace caches
+{
+
+inline CacheMetrics::CacheMetrics( const CacheMetrics& other )
+{
+    *this = other;
+}
+
+inline CacheMetrics::CacheMetrics( CacheMetrics&& other )
+{
+    *this = other;
+}
+
+inline CacheMetrics& CacheMetrics::operator=( const CacheMetrics& other )
+{
+    Snapshot values = other.read ();
+
+    for (size_t i = 0; i < COUNTERS_NUM; ++i)
+        counters_[i].store (values[i], std::memory_order_relaxed);
+
+    return *this;
+}
+
+inline CacheMetrics& CacheMetrics::operator=( CacheMetrics&& other )
+{
+    return *this = other;
+}
+
+inline void CacheMetrics::add( Counter counter, std::uint64_t delta )
+{
+    std::atomic<std::uint64_t>& value = counters_[counter];
+
+    value.store (value.load (std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline void CacheMetrics::addLoadTime( std::chrono::nanoseconds time )
+{
+    std::uint64_t timeNs = time.count ();
+
+    add (LOADS);
+    add (LOADS_TIME_NS, timeNs);
+
+    std::atomic<std::uint64_t>& maxTime = counters_[MAX_LOAD_TIME_NS];
+    if (maxTime.load (std::memory_order_relaxed) < timeNs)
+        maxTime.store (timeNs, std::memory_order_relaxed);
+}
+
+inline CacheMetrics::Snapshot CacheMetrics::read() const
+{
+    Snapshot values {};
+
+    for (size_t i = 0; i < COUNTERS_NUM; ++i)
+        values[i] = counters_[i].load (std::memory_order_relaxed);
+
+    return values;
+}
+
+inline const char * getCounterName( CacheMetrics::Counter counter )
+{
+    static const char * NAMES[CacheMetrics::COUNTERS_NUM] =
+    {
+        "hits", "am_hits", "alin_hits", "alout_hits", "misses", "evictions", "promotions", "rejections",
+        "loads", "loads_time_ns", "max_load_time_ns"
+    };
+
+    return NAMES[counter];
+}
+
+inline void mergeSnapshot( CacheMetrics::Snapshot& to, const CacheMetrics::Snapshot& from )
+{
+    for (size_t i = 0; i < CacheMetrics::COUNTERS_NUM; ++i)
+        to[i] = i == CacheMetrics::MAX_LOAD_TIME_NS ? std::max (to[i], from[i]) : to[i] + from[i];
+}
+
+inline void printSnapshot( std::ostream& out, const char * cacheName, const CacheMetrics::Snapshot& values )
+{
+    std::uint64_t hitsNum = values[CacheMetrics::HITS] + values[CacheMetrics::AM_HITS] +
+                            values[CacheMetrics::ALIN_HITS] + values[CacheMetrics::ALOUT_HITS];
+    std::uint64_t requestsNum = hitsNum + values[CacheMetrics::MISSES];
+
+    std::chrono::milliseconds time = std::chrono::duration_cast<std::chrono::milliseconds>
+        (std::chrono::system_clock::now ().time_since_epoch ());
+
+    out << "{\"cache\": \"" << cacheName << "\", \"time_ms\": " << time.count ();
+    for (size_t i = 0; i < CacheMetrics::COUNTERS_NUM; ++i)
+        out << ", \"" << getCounterName (static_cast<CacheMetrics::Counter> (i)) << "\": " << values[i];
+    out << ", \"hit_rate\": " << (requestsNum == 0 ? 0. : static_cast<double> (hitsNum) / requestsNum) << "}\n";
+
+    out.flush ();
+}
+
+inline MetricsDumper::MetricsDumper( std::function<CacheMetrics::Snapshot()> read, std::ostream& out,
+                                     const char * cacheName, std::chrono::milliseconds period ) :
+    read_ (std::move (read)),
+    out_ (out),
+    cacheName_ (cacheName),
+    period_ (period),
+    thread_ ([this] { dump (); })
+{}
+
+inline MetricsDumper::~MetricsDumper()
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        stop_ = true;
+    }
+    stopCond_.notify_one ();
+    thread_.join ();
+
+    printSnapshot (out_, cacheName_, read_ ());
+}
+
+inline void MetricsDumper::dump()
+{
+    std::unique_lock<std::mutex> lock {mutex_};
+
+    while (!stopCond_.wait_for (lock, period_, [this] { return stop_; }))
+        printSnapshot (out_, cacheName_, read_ ());
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_METRICS_IMPL_HH_INCL
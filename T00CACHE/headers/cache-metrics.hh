@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifndef CACHE_METRICS_HH_INCL
+#define CACHE_METRICS_HH_INCL
+
+namespace caches {
+
+// Cache events counters.
+// Each counter has one writer: cache owner or thread holding cache lock,
+// so increments are plain relaxed load & store without lock prefix.
+// Counters can be read from any thread at any time without locking.
+class CacheMetrics
+{
+public:
+
+    enum Counter : size_t
+    {
+        // Hits of caches without segments (LRU, CLOCK, CLOCK-Pro).
+        HITS,
+        AM_HITS,
+        ALIN_HITS,
+        ALOUT_HITS,
+        MISSES,
+        // Elements removed from cache.
+        EVICTIONS,
+        // Elements moved from ALout to AM.
+        PROMOTIONS,
+        // Loaded elements not cached by admission filter.
+        REJECTIONS,
+
+        LOADS,
+        LOADS_TIME_NS,
+        MAX_LOAD_TIME_NS,
+
+        COUNTERS_NUM
+    };
+
+    // Counters values at some moment.
+    using Snapshot = std::array<std::uint64_t, COUNTERS_NUM>;
+
+private:
+
+    std::array<std::atomic<std::uint64_t>, COUNTERS_NUM> counters_ {};
+
+public:
+
+    CacheMetrics() = default;
+
+   ~CacheMetrics() = default;
+    // Copy gets current counters values.
+    CacheMetrics( const CacheMetrics& );
+    CacheMetrics( CacheMetrics&& );
+    CacheMetrics& operator=( const CacheMetrics& );
+    CacheMetrics& operator=( CacheMetrics&& );
+
+    // Should be called by counters writer only.
+    void add( Counter, std::uint64_t delta = 1 );
+    void addLoadTime( std::chrono::nanoseconds );
+
+    Snapshot read() const;
+};
+
+// Json field name for counter.
+const char * getCounterName( CacheMetrics::Counter );
+
+// Sums counters of snapshots (max for max counters).
+void mergeSnapshot( CacheMetrics::Snapshot& to, const CacheMetrics::Snapshot& from );
+
+// Prints snapshot as json line: cache name, counters & hit rate.
+void printSnapshot( std::ostream&, const char * cacheName, const CacheMetrics::Snapshot& );
+
+// Prints metrics got with read function as json lines each period
+// in its own thread. Metrics are printed for the last time in dtor.
+class MetricsDumper
+{
+    std::function<CacheMetrics::Snapshot()> read_;
+    std::ostream& out_;
+    const char * cacheName_;
+    const std::chrono::milliseconds period_;
+
+    std::mutex mutex_;
+    std::condition_variable stopCond_;
+    bool stop_ = false;
+
+    std::thread thread_;
+
+    void dump();
+
+public:
+
+    // out & cacheName should live longer than dumper.
+    MetricsDumper( std::function<CacheMetrics::Snapshot()> read, std::ostream& out,
+                   const char * cacheName, std::chrono::milliseconds period );
+
+   ~MetricsDumper();
+    MetricsDumper( const MetricsDumper& ) = delete;
+    MetricsDumper( MetricsDumper&& ) = delete;
+    MetricsDumper& operator=( const MetricsDumper& ) = delete;
+    MetricsDumper& operator=( MetricsDumper&& ) = delete;
+};
+
+} // namespace caches
+
+#include "cache-metrics-impl.hh"
+
+#endif // #ifndef CACHE_METRICS_HH_INCL
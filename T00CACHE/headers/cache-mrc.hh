@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifndef CACHE_MRC_HH_INCL
+#define CACHE_MRC_HH_INCL
+
+#include "cache-tests.hh"
+
+namespace caches
+{
+
+// Miss ratio curves (hit rate vs capacity) for whole requests sequence.
+
+// LRU stack distances of requests, computed in one pass (Mattson's algorithm).
+// Stack distance of request = number of distinct ids requested since previous
+// request with the same id. LRU cache with capacity C hits all requests
+// with distance < C, so one pass gives LRU hits for all capacities.
+class StackDistances
+{
+    // hitsNum_[C] = number of requests with distance < C.
+    std::vector<size_t> hitsNum_;
+    size_t requestsNum_ = 0;
+    size_t distinctIdsNum_ = 0;
+
+public:
+
+    // Distances are computed in O(idsNum * log(idsNum)) with Fenwick tree over
+    // requests positions: only the last request of each id is marked in it.
+    // Distances >= maxCapacity are not stored.
+    StackDistances( const testPageId_t * ids, size_t idsNum, size_t maxCapacity );
+
+    size_t getRequestsNum() const;
+    size_t getDistinctIdsNum() const;
+    size_t getMaxCapacity() const;
+
+    // LRU hits number for capacity <= getMaxCapacity ().
+    size_t getLruHits( size_t capacity ) const;
+};
+
+// Simulates Cache2Q with each of capacities over the same requests
+// sequence. Simulations are distributed between threadsNum threads.
+// Returns hits numbers in the same order as capacities.
+std::vector<size_t> sample2QHits( const testPageId_t * ids, size_t idsNum,
+                                  const std::vector<size_t>& capacities, size_t threadsNum );
+
+// Capacities from minCapacity to maxCapacity evenly distributed in log scale.
+std::vector<size_t> getLogCapacities( size_t minCapacity, size_t maxCapacity, size_t pointsNum );
+
+// Prints LRU hit rate for each capacity 1 .. maxCapacity and 2Q hit rate for
+// pointsNum capacities in csv format: <POLICY>,<CAPACITY>,<HITS>,<HIT RATE>.
+// maxCapacity = 0 means number of distinct ids in sequence.
+void printMissRatioCurves( const testPageId_t * ids, size_t idsNum,
+                           size_t maxCapacity, size_t pointsNum, size_t threadsNum );
+
+// Workload summary of requests sequence.
+struct TraceStats
+{
+    size_t requestsNum_ = 0;
+    size_t distinctIdsNum_ = 0;
+    // Ids requested only once, they are never hit.
+    size_t onceIdsNum_ = 0;
+    // Reuse (stack) distances histogram in log scale: reusesNum_[0] is
+    // number of requests with distance 0, reusesNum_[k] - with distance
+    // in [2^(k-1), 2^k). First requests of ids have no distance.
+    std::vector<size_t> reusesNum_;
+};
+
+TraceStats getTraceStats( const testPageId_t * ids, size_t idsNum );
+
+// Prints ids numbers & reuse distances histogram in csv format:
+// <MIN DISTANCE>,<MAX DISTANCE>,<REUSES>,<REUSES SHARE>.
+void printTraceStats( const TraceStats& stats );
+
+} // namespace caches
+
+#endif // #ifndef CACHE_MRC_HH_INCL
@@ -0,0 +1,743 @@
+#ifndef CACHE_POLICY_IMPL_HH_INCL
+#define CACHE_POLICY_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T, typename T_id>
+std::vector<T> LoadEach<T, T_id>::operator()( const T_id * ids, size_t idsNum ) const
+{
+    std::vector<T> elems {};
+    elems.reserve (idsNum);
+
+    for (size_t i = 0; i < idsNum; ++i)
+        elems.emplace_back (ids[i]);
+
+    return elems;
+}
+
+template <typename T, typename T_id, typename BatchLoad, typename Add>
+void loadBatchMisses( const T_id * ids, T * elems, const std::vector<size_t>& missPos,
+                      BatchLoad& load, Add add )
+{
+    if (missPos.empty ())
+        return;
+
+    // Batch can request the same missed id several times.
+    std::vector<T_id> missIds {};
+    missIds.reserve (missPos.size ());
+    for (size_t pos : missPos)
+        missIds.push_back (ids[pos]);
+
+    std::sort (missIds.begin (), missIds.end ());
+    missIds.erase (std::unique (missIds.begin (), missIds.end ()), missIds.end ());
+
+    std::vector<T> loaded = load (missIds.data (), missIds.size ());
+    assert (loaded.size () == missIds.size ());
+
+    for (size_t pos : missPos)
+    {
+        size_t loadedId = std::lower_bound (missIds.begin (), missIds.end (), ids[pos]) - missIds.begin ();
+
+        add (ids[pos], loaded[loadedId]);
+        elems[pos] = loaded[loadedId];
+    }
+}
+
+inline LruEviction::LruEviction( size_t )
+{}
+
+inline void LruEviction::reserve( size_t slotsNum )
+{
+    lists_.reserve (slotsNum);
+}
+
+inline void LruEviction::onInsert( slot_t slot )
+{
+    lists_.link2Front (0, slot);
+}
+
+inline slot_t LruEviction::onHit( slot_t slot, CacheMetrics& metrics )
+{
+    metrics.add (CacheMetrics::HITS);
+    lists_.move2Front (0, slot);
+
+    return NIL_SLOT;
+}
+
+inline slot_t LruEviction::victim()
+{
+    return lists_.size (0) < lists_.slotsNum () ? NIL_SLOT : lists_.back (0);
+}
+
+inline void LruEviction::erase( slot_t slot )
+{
+    lists_.unlink (0, slot);
+}
+
+inline FifoEviction::FifoEviction( size_t )
+{}
+
+inline void FifoEviction::reserve( size_t slotsNum )
+{
+    lists_.reserve (slotsNum);
+}
+
+inline void FifoEviction::onInsert( slot_t slot )
+{
+    lists_.link2Front (0, slot);
+}
+
+inline slot_t FifoEviction::onHit( slot_t, CacheMetrics& metrics )
+{
+    metrics.add (CacheMetrics::HITS);
+    return NIL_SLOT;
+}
+
+inline slot_t FifoEviction::victim()
+{
+    return lists_.size (0) < lists_.slotsNum () ? NIL_SLOT : lists_.back (0);
+}
+
+inline void FifoEviction::erase( slot_t slot )
+{
+    lists_.unlink (0, slot);
+}
+
+inline ClockEviction::ClockEviction( size_t )
+{}
+
+inline void ClockEviction::reserve( size_t slotsNum )
+{
+    if (slotsNum > refs_.size ())
+        refs_.resize (slotsNum);
+}
+
+inline void ClockEviction::onInsert( slot_t slot )
+{
+    refs_[slot] = 0;
+    ++size_;
+}
+
+inline slot_t ClockEviction::onHit( slot_t slot, CacheMetrics& metrics )
+{
+    metrics.add (CacheMetrics::HITS);
+    refs_[slot] = 1;
+
+    return NIL_SLOT;
+}
+
+inline slot_t ClockEviction::victim()
+{
+    if (size_ < refs_.size ())
+        return NIL_SLOT;
+
+    // Referenced elements get second chance.
+    while (refs_[hand_])
+    {
+        refs_[hand_] = 0;
+        hand_ = (hand_ + 1) % refs_.size ();
+    }
+
+    return hand_;
+}
+
+inline void ClockEviction::erase( slot_t slot )
+{
+    --size_;
+
+    // Freed slot is reused for new element, so hand goes on.
+    if (slot == hand_)
+        hand_ = (hand_ + 1) % refs_.size ();
+}
+
+inline TwoQEviction::TwoQEviction( size_t capacity )
+{
+    capacities_[AM] = std::max<size_t> (std::trunc (AM_QUOTA_ * capacity), MIN_AM_CAPACITY_);
+    capacities_[ALIN] = std::max<size_t> (std::trunc (ALIN_QUOTA_ * capacity), MIN_ALIN_CAPACITY_);
+    capacities_[ALOUT] = std::max<size_t> (capacity - capacities_[AM] - capacities_[ALIN], MIN_ALOUT_CAPACITY_);
+}
+
+inline void TwoQEviction::reserve( size_t slotsNum )
+{
+    lists_.reserve (slotsNum);
+    if (slotsNum > segments_.size ())
+        segments_.resize (slotsNum);
+}
+
+inline void TwoQEviction::onInsert( slot_t slot )
+{
+    // Need to free space in alin. Space in alout is freed by victim ().
+    if (capacities_[ALIN] <= lists_.size (ALIN))
+    {
+        slot_t alinTail = lists_.back (ALIN);
+
+        lists_.splice2Front (ALIN, alinTail, ALOUT);
+        segments_[alinTail] = ALOUT;
+    }
+
+    // Placing new element in alin.
+    restore (ALIN, slot);
+}
+
+inline slot_t TwoQEviction::onHit( slot_t slot, CacheMetrics& metrics )
+{
+    switch (segments_[slot])
+    {
+        case AM:
+            metrics.add (CacheMetrics::AM_HITS);
+
+            lists_.move2Front (AM, slot);
+            return NIL_SLOT;
+
+        // Move element form alout to the head of am.
+        case ALOUT:
+        {
+            metrics.add (CacheMetrics::ALOUT_HITS);
+            metrics.add (CacheMetrics::PROMOTIONS);
+
+            slot_t amVictim = capacities_[AM] <= lists_.size (AM) ? lists_.back (AM) : NIL_SLOT;
+
+            lists_.splice2Front (ALOUT, slot, AM);
+            segments_[slot] = AM;
+
+            return amVictim;
+        }
+
+        // Do nothing.
+        default:
+            metrics.add (CacheMetrics::ALIN_HITS);
+            return NIL_SLOT;
+    }
+}
+
+inline slot_t TwoQEviction::victim()
+{
+    if (lists_.size (ALIN) < capacities_[ALIN] || lists_.size (ALOUT) < capacities_[ALOUT])
+        return NIL_SLOT;
+
+    return lists_.back (ALOUT);
+}
+
+inline void TwoQEviction::erase( slot_t slot )
+{
+    lists_.unlink (segments_[slot], slot);
+}
+
+inline size_t TwoQEviction::size( size_t segId ) const
+{
+    return lists_.size (segId);
+}
+
+inline size_t TwoQEviction::capacity( size_t segId ) const
+{
+    return capacities_[segId];
+}
+
+inline slot_t TwoQEviction::front( size_t segId ) const
+{
+    return lists_.front (segId);
+}
+
+inline slot_t TwoQEviction::next( slot_t slot ) const
+{
+    return lists_.next (slot);
+}
+
+inline void TwoQEviction::restore( size_t segId, slot_t slot )
+{
+    lists_.link2Front (segId, slot);
+    segments_[slot] = segId;
+}
+
+template <typename T_id>
+MapIndex<T_id>::MapIndex( size_t maxSize )
+{
+    map_.reserve (maxSize);
+}
+
+template <typename T_id>
+slot_t MapIndex<T_id>::find( T_id id ) const
+{
+    auto it = map_.find (id);
+    return it == map_.end () ? NIL_SLOT : it->second;
+}
+
+template <typename T_id>
+void MapIndex<T_id>::insert( T_id id, slot_t slot )
+{
+    assert (find (id) == NIL_SLOT);
+    map_.emplace (id, slot);
+}
+
+template <typename T_id>
+void MapIndex<T_id>::reserve( size_t maxSize )
+{
+    map_.reserve (maxSize);
+}
+
+template <typename T_id>
+void MapIndex<T_id>::erase( T_id id )
+{
+    map_.erase (id);
+}
+
+template <typename T>
+FlatValues<T>::FlatValues( size_t capacity ) :
+    values_ (capacity)
+{}
+
+template <typename T>
+void FlatValues<T>::reserve( size_t capacity )
+{
+    if (capacity > values_.size ())
+        values_.resize (capacity);
+}
+
+template <typename T>
+template <typename... Args>
+T& FlatValues<T>::emplace( slot_t slot, Args&&... args )
+{
+    assert (!values_[slot]);
+    return values_[slot].emplace (std::forward<Args> (args)...);
+}
+
+template <typename T>
+T& FlatValues<T>::get( slot_t slot )
+{
+    return *values_[slot];
+}
+
+template <typename T>
+const T& FlatValues<T>::get( slot_t slot ) const
+{
+    return *values_[slot];
+}
+
+template <typename T>
+void FlatValues<T>::destroy( slot_t slot )
+{
+    values_[slot].reset ();
+}
+
+template <typename T>
+NodeValues<T>::NodeValues( size_t capacity ) :
+    values_ (capacity)
+{}
+
+template <typename T>
+void NodeValues<T>::reserve( size_t capacity )
+{
+    if (capacity > values_.size ())
+        values_.resize (capacity);
+}
+
+template <typename T>
+template <typename... Args>
+T& NodeValues<T>::emplace( slot_t slot, Args&&... args )
+{
+    assert (!values_[slot]);
+    values_[slot] = std::make_unique<T> (std::forward<Args> (args)...);
+
+    return *values_[slot];
+}
+
+template <typename T>
+T& NodeValues<T>::get( slot_t slot )
+{
+    return *values_[slot];
+}
+
+template <typename T>
+const T& NodeValues<T>::get( slot_t slot ) const
+{
+    return *values_[slot];
+}
+
+template <typename T>
+void NodeValues<T>::destroy( slot_t slot )
+{
+    values_[slot].reset ();
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::PolicyCache( size_t capacity, bool admissionFilter ) :
+    eviction_ (capacity),
+    index_ (std::max (capacity, MIN_CAPACITY_)),
+    values_ (std::max (capacity, MIN_CAPACITY_)),
+    ids_ (std::max (capacity, MIN_CAPACITY_))
+{
+    size_t slotsNum = ids_.size ();
+    assert (slotsNum < NIL_SLOT);
+
+    eviction_.reserve (slotsNum);
+
+    // Free slots are taken from 0.
+    freeSlots_.reserve (slotsNum);
+    for (slot_t slot = slotsNum; slot-- > 0;)
+        freeSlots_.push_back (slot);
+
+    if (admissionFilter)
+        sketch_.emplace (slotsNum);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+typename PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::ElemRef
+PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::getElem( T_id id )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    slot_t slot = lookup (id);
+    if (slot != NIL_SLOT)
+        return values_.get (slot);
+
+    // Element isn't cached => load element to cache.
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+    const T& loaded = load2Cache (id, id);
+    metrics_.addLoadTime (std::chrono::steady_clock::now () - begin);
+
+    return loaded;
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+template <typename BatchLoad>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::getElems( const T_id * ids, size_t idsNum,
+                                                                           T * elems, BatchLoad load )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    std::vector<size_t> missPos {};
+
+    for (size_t chunkBegin = 0; chunkBegin < idsNum; chunkBegin += PREFETCH_CHUNK)
+    {
+        size_t chunkEnd = std::min (chunkBegin + PREFETCH_CHUNK, idsNum);
+
+        // All bucket loads are in flight before the first probe.
+        for (size_t i = chunkBegin; i < chunkEnd; ++i)
+            index_.prefetch (ids[i]);
+
+        for (size_t i = chunkBegin; i < chunkEnd; ++i)
+        {
+            slot_t slot = lookup (ids[i]);
+            if (slot != NIL_SLOT)
+                elems[i] = values_.get (slot);
+            else
+                missPos.push_back (i);
+        }
+    }
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+    loadBatchMisses (ids, elems, missPos, load, [this]( T_id id, const T& elem ) { insert (id, elem); });
+
+    // The whole batch load is registered as one load.
+    if (!missPos.empty ())
+        metrics_.addLoadTime (std::chrono::steady_clock::now () - begin);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+const T * PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::findElem( T_id id )
+{
+    static_assert (!Concurrency::IS_THREAD_SAFE, "Pointer to element cannot be used after unlock");
+
+    slot_t slot = lookup (id);
+    return slot == NIL_SLOT ? nullptr : &values_.get (slot);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+typename PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::ElemRef
+PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::addLoaded( T_id id, T elem )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    return insert (id, std::move (elem));
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::addElem( EnId<T, T_id> pair )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    slot_t oldSlot = index_.find (pair.second);
+    if (oldSlot != NIL_SLOT) // Remove old value.
+    {
+        eviction_.erase (oldSlot);
+        remove (oldSlot);
+    }
+
+    // Element is cached anyway, so admission filter is not asked.
+    slot_t victim = eviction_.victim ();
+    if (victim != NIL_SLOT)
+        evict (victim);
+
+    eviction_.onInsert (emplace (pair.second, std::move (pair.first)));
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::addLoadTime( std::chrono::nanoseconds time )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    metrics_.addLoadTime (time);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::setEvictHandler(
+    std::function<void( T_id, T&& )> handler )
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    evictHandler_ = std::move (handler);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+bool PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::isCached( T_id id ) const
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    return index_.find (id) != NIL_SLOT;
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+size_t PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::size() const
+{
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    return ids_.size () - freeSlots_.size ();
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+CacheMetrics::Snapshot PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::getMetrics() const
+{
+    return metrics_.read ();
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+bool PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::saveSnapshot( const char * filename,
+                                                                               bool withValues ) const
+{
+    static_assert (Eviction::SEGMENTS_NUM == SnapshotHeader::SEGMENTS_NUM, "Snapshot keeps 2Q segments");
+    static_assert (std::is_trivially_copyable_v<T_id>, "Ids are saved as is");
+    assert (filename != nullptr);
+
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    if (withValues && !std::is_trivially_copyable_v<T>)
+        return false;
+
+    std::ofstream out {filename, std::ios::binary};
+    if (!out.is_open ())
+        return false;
+
+    SnapshotHeader header {};
+    std::memcpy (header.magic_, SnapshotHeader::MAGIC, sizeof (header.magic_));
+    header.version_ = SnapshotHeader::VERSION;
+    header.idSize_ = sizeof (T_id);
+    header.elemSize_ = withValues ? sizeof (T) : 0;
+    for (size_t seg = 0; seg < Eviction::SEGMENTS_NUM; ++seg)
+        header.segmentSizes_[seg] = eviction_.size (seg);
+
+    out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+
+    for (size_t seg = 0; seg < Eviction::SEGMENTS_NUM; ++seg)
+    {
+        for (slot_t slot = eviction_.front (seg); slot != NIL_SLOT; slot = eviction_.next (slot))
+            out.write (reinterpret_cast<const char *> (&ids_[slot]), sizeof (T_id));
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+            if (withValues)
+                for (slot_t slot = eviction_.front (seg); slot != NIL_SLOT; slot = eviction_.next (slot))
+                    out.write (reinterpret_cast<const char *> (&values_.get (slot)), sizeof (T));
+    }
+
+    return static_cast<bool> (out);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+template <typename BatchLoad>
+bool PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::loadSnapshot( const char * filename,
+                                                                               BatchLoad load )
+{
+    static_assert (Eviction::SEGMENTS_NUM == SnapshotHeader::SEGMENTS_NUM, "Snapshot keeps 2Q segments");
+    assert (filename != nullptr);
+
+    [[maybe_unused]] auto lock = concurrency_.lock ();
+
+    if (freeSlots_.size () != ids_.size ())
+        return false;
+
+    MappedFile file {filename};
+    if (file.size () < sizeof (SnapshotHeader))
+        return false;
+
+    SnapshotHeader header {};
+    std::memcpy (&header, file.data (), sizeof (header));
+
+    size_t elemSize = header.elemSize_;
+    if (std::memcmp (header.magic_, SnapshotHeader::MAGIC, sizeof (header.magic_)) ||
+        header.version_ != SnapshotHeader::VERSION || header.idSize_ != sizeof (T_id) ||
+        (elemSize != 0 && (elemSize != sizeof (T) || !std::is_trivially_copyable_v<T>)))
+        return false;
+
+    size_t expectedSize = sizeof (header);
+    for (size_t seg = 0; seg < Eviction::SEGMENTS_NUM; ++seg)
+        expectedSize += header.segmentSizes_[seg] * (sizeof (T_id) + elemSize);
+    if (file.size () != expectedSize)
+        return false;
+
+    const unsigned char * segData = file.data () + sizeof (header);
+
+    for (size_t seg = 0; seg < Eviction::SEGMENTS_NUM; ++seg)
+    {
+        size_t storedNum = header.segmentSizes_[seg];
+        size_t keptNum = std::min (storedNum, eviction_.capacity (seg));
+        const unsigned char * ids = segData;
+        const unsigned char * elems = segData + storedNum * sizeof (T_id);
+        segData = elems + storedNum * elemSize;
+
+        // Elements are placed from the least recent one, each to the segment head.
+        for (size_t chunkEnd = keptNum; chunkEnd > 0;)
+        {
+            size_t chunkBegin = chunkEnd - std::min (chunkEnd, SNAPSHOT_CHUNK_);
+
+            std::vector<T_id> chunkIds (chunkEnd - chunkBegin);
+            std::memcpy (chunkIds.data (), ids + chunkBegin * sizeof (T_id), chunkIds.size () * sizeof (T_id));
+
+            std::vector<T> loaded {};
+            if (elemSize == 0)
+            {
+                loaded = load (chunkIds.data (), chunkIds.size ());
+                assert (loaded.size () == chunkIds.size ());
+            }
+
+            for (size_t i = chunkIds.size (); i-- > 0;)
+            {
+                // Snapshot is broken.
+                if (index_.find (chunkIds[i]) != NIL_SLOT)
+                    return false;
+
+                if (elemSize == 0)
+                {
+                    eviction_.restore (seg, emplace (chunkIds[i], std::move (loaded[i])));
+                    continue;
+                }
+
+                if constexpr (std::is_trivially_copyable_v<T>)
+                {
+                    alignas (T) unsigned char elemBytes[sizeof (T)];
+                    std::memcpy (elemBytes, elems + (chunkBegin + i) * sizeof (T), sizeof (T));
+                    eviction_.restore (seg, emplace (chunkIds[i], *std::launder (reinterpret_cast<T *> (elemBytes))));
+                }
+            }
+
+            chunkEnd = chunkBegin;
+        }
+    }
+
+    return true;
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+slot_t PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::lookup( T_id id )
+{
+    if (sketch_)
+        sketch_->add (id);
+
+    slot_t slot = index_.find (id);
+    if (slot == NIL_SLOT)
+    {
+        metrics_.add (CacheMetrics::MISSES);
+        return NIL_SLOT;
+    }
+
+    slot_t victim = eviction_.onHit (slot, metrics_);
+    if (victim != NIL_SLOT)
+        evict (victim);
+
+    return slot;
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+const T& PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::insert( T_id id, T elem )
+{
+    slot_t slot = index_.find (id);
+    if (slot != NIL_SLOT)
+        return values_.get (slot);
+
+    return load2Cache (id, std::move (elem));
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+template <typename... Args>
+const T& PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::load2Cache( T_id id, Args&&... args )
+{
+    slot_t victim = eviction_.victim ();
+    if (victim != NIL_SLOT)
+    {
+        if (sketch_ && sketch_->estimate (id) <= sketch_->estimate (ids_[victim]))
+        {
+            metrics_.add (CacheMetrics::REJECTIONS);
+            return bypassed_.emplace (std::forward<Args> (args)...);
+        }
+
+        evict (victim);
+    }
+
+    slot_t slot = emplace (id, std::forward<Args> (args)...);
+    eviction_.onInsert (slot);
+
+    return values_.get (slot);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+template <typename... Args>
+slot_t PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::emplace( T_id id, Args&&... args )
+{
+    // Slots number grows only if eviction keeps unbounded segment.
+    if (freeSlots_.empty ())
+    {
+        size_t slotsNum = ids_.size ();
+        size_t newSlotsNum = 2 * slotsNum;
+        assert (newSlotsNum < NIL_SLOT);
+
+        eviction_.reserve (newSlotsNum);
+        index_.reserve (newSlotsNum);
+        values_.reserve (newSlotsNum);
+        ids_.resize (newSlotsNum);
+
+        for (slot_t slot = newSlotsNum; slot-- > slotsNum;)
+            freeSlots_.push_back (slot);
+    }
+
+    slot_t slot = freeSlots_.back ();
+    freeSlots_.pop_back ();
+
+    values_.emplace (slot, std::forward<Args> (args)...);
+    ids_[slot] = id;
+    index_.insert (id, slot);
+
+    return slot;
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::evict( slot_t slot )
+{
+    metrics_.add (CacheMetrics::EVICTIONS);
+    eviction_.erase (slot);
+
+    if (evictHandler_)
+        evictHandler_ (ids_[slot], std::move (values_.get (slot)));
+
+    remove (slot);
+}
+
+template <typename T, typename T_id, typename Eviction, typename Index, typename Values, typename Concurrency>
+void PolicyCache<T, T_id, Eviction, Index, Values, Concurrency>::remove( slot_t slot )
+{
+    index_.erase (ids_[slot]);
+    values_.destroy (slot);
+    freeSlots_.push_back (slot);
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_POLICY_IMPL_HH_INCL
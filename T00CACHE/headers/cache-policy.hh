@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef CACHE_POLICY_HH_INCL
+#define CACHE_POLICY_HH_INCL
+
+#include "cache-storage.hh"
+#include "cache-metrics.hh"
+#include "cache-sketch.hh"
+#include "cache-snapshot.hh"
+
+namespace caches {
+
+// To store element + its id.
+template <typename T, typename T_id>
+using EnId = typename std::pair<T, T_id>;
+
+// Default batch loader for getElems: constructs each element from its id.
+template <typename T, typename T_id>
+struct LoadEach
+{
+    std::vector<T> operator()( const T_id * ids, size_t idsNum ) const;
+};
+
+// Loads misses of getElems batch with one load call. Each missed id is
+// loaded once, then add (id, elem) is called for misses in batch order.
+// missPos = positions of missed ids in batch.
+template <typename T, typename T_id, typename BatchLoad, typename Add>
+void loadBatchMisses( const T_id * ids, T * elems, const std::vector<size_t>& missPos,
+                      BatchLoad& load, Add add );
+
+/* Policies of PolicyCache. All of them are resolved at compile time.
+
+   Eviction policy works with element slots only. Cache has
+   max (capacity, MIN_CAPACITY) slots, new element takes free slot &
+   slot of removed element becomes free. Interface:
+
+       static constexpr size_t MIN_CAPACITY;
+       Eviction( size_t capacity );
+       void reserve( size_t slotsNum ); - slots [0, slotsNum) can be used
+       void onInsert( slot_t );         - element is placed to slot
+       slot_t onHit( slot_t, CacheMetrics& );
+                                        - element in slot is requested, hit is
+                                          added to metrics. Returns slot to evict
+                                          after hit or NIL_SLOT
+       slot_t victim();                 - slot to evict for new element or
+                                          NIL_SLOT if it fits without eviction
+       void erase( slot_t );            - element is evicted or replaced
+
+   If victim () is NIL_SLOT and there are no free slots, slots number is
+   doubled. Segmented policy (for snapshots) also has:
+
+       static constexpr size_t SEGMENTS_NUM;
+       size_t size( size_t segId ) const;
+       size_t capacity( size_t segId ) const;
+       slot_t front( size_t segId ) const; - the most recent slot of segment
+       slot_t next( slot_t ) const;        - NIL_SLOT for the least recent one
+       void restore( size_t segId, slot_t ); - element is placed to segment head
+
+   Index maps ids to slots, interface is the same as FlatIndex one:
+
+       Index( size_t maxSize );
+       slot_t find( T_id ) const;   - NIL_SLOT for not stored id
+       void insert( T_id, slot_t );
+       void reserve( size_t maxSize );
+       void erase( T_id );
+       void prefetch( T_id ) const;
+
+   Values keep elements by slots:
+
+       Values( size_t capacity );
+       void reserve( size_t capacity );
+       template <typename... Args>
+       T& emplace( slot_t, Args&&... ); - slot should be empty
+       T& get( slot_t );
+       const T& get( slot_t ) const;
+       void destroy( slot_t );
+
+   Concurrency defines lock for each cache call:
+
+       static constexpr bool IS_THREAD_SAFE;
+       Lock lock() const;           - Lock is some RAII type
+*/
+
+// Evicts the least recently used element.
+class LruEviction
+{
+    // From the most to the least recently used slot.
+    SlotLists<1> lists_;
+
+public:
+
+    static constexpr size_t MIN_CAPACITY = 1;
+
+    LruEviction( size_t capacity );
+
+    void reserve( size_t slotsNum );
+    void onInsert( slot_t );
+    slot_t onHit( slot_t, CacheMetrics& );
+    slot_t victim();
+    void erase( slot_t );
+};
+
+// Evicts the oldest element.
+class FifoEviction
+{
+    // From the newest to the oldest slot.
+    SlotLists<1> lists_;
+
+public:
+
+    static constexpr size_t MIN_CAPACITY = 1;
+
+    FifoEviction( size_t capacity );
+
+    void reserve( size_t slotsNum );
+    void onInsert( slot_t );
+    slot_t onHit( slot_t, CacheMetrics& );
+    slot_t victim();
+    void erase( slot_t );
+};
+
+// CLOCK approximation of LRU: hit only sets element reference bit,
+// so hits do not change any links. Clock hand goes over slots evicting
+// first element with cleared reference bit, set bits are cleared on the way.
+class ClockEviction
+{
+    // Reference bit for each slot. Byte per slot: std::vector<bool> packs
+    // neighbour slots bits in one word, so their updates would race.
+    std::vector<std::uint8_t> refs_;
+    // Number of used slots.
+    size_t size_ = 0;
+    // Slot to check next.
+    slot_t hand_ = 0;
+
+public:
+
+    static constexpr size_t MIN_CAPACITY = 1;
+
+    ClockEviction( size_t capacity );
+
+    void reserve( size_t slotsNum );
+    void onInsert( slot_t );
+    slot_t onHit( slot_t, CacheMetrics& );
+    slot_t victim();
+    void erase( slot_t );
+};
+
+// 2Q: new elements are placed to ALin, elements pushed out of ALin are
+// kept in ALout, ALout hits are promoted to AM. So elements accessed only
+// once (e.g. by scans) do not evict hot ones from AM.
+class TwoQEviction
+{
+public:
+
+    // Slots segments:
+    enum Segment : size_t
+    {
+        // To store hottest elements. Managed as LRU.
+        AM,
+        // For once accesed elements. Managed as FIFO.
+        ALIN,
+        // For way back accessed elements. Managed as FIFO.
+        ALOUT,
+
+        SEGMENTS_NUM
+    };
+
+private:
+
+    // Good proportions for lists capacities.
+    static constexpr double AM_QUOTA_ = 0.25;
+    static constexpr double ALIN_QUOTA_ = 0.25;
+    static_assert (AM_QUOTA_ + ALIN_QUOTA_ <= 1,
+        "AM_QUOTA_ + ALIN_QUOTA_ cant be above 1.0");
+
+    // Minimum capacities for lists.
+    static constexpr size_t MIN_AM_CAPACITY_ = 1;
+    static constexpr size_t MIN_ALIN_CAPACITY_ = 1;
+    static constexpr size_t MIN_ALOUT_CAPACITY_ = 2;
+
+    // Lists capacities. ALout capacity underflows for capacity < 2,
+    // as in list based version, so slots number grows then.
+    std::array<size_t, SEGMENTS_NUM> capacities_;
+
+    SlotLists<SEGMENTS_NUM> lists_;
+    // Segment of each used slot.
+    std::vector<std::uint8_t> segments_;
+
+public:
+
+    static constexpr size_t MIN_CAPACITY =
+        MIN_AM_CAPACITY_ + MIN_ALIN_CAPACITY_ + MIN_ALOUT_CAPACITY_;
+
+    TwoQEviction( size_t capacity );
+
+    void reserve( size_t slotsNum );
+    void onInsert( slot_t );
+    slot_t onHit( slot_t, CacheMetrics& );
+    slot_t victim();
+    void erase( slot_t );
+
+    size_t size( size_t segId ) const;
+    size_t capacity( size_t segId ) const;
+    slot_t front( size_t segId ) const;
+    slot_t next( slot_t ) const;
+    void restore( size_t segId, slot_t );
+};
+
+// Index on std::unordered_map, for ids without cheap hash mixing.
+template <typename T_id>
+class MapIndex
+{
+    std::unordered_map<T_id, slot_t> map_;
+
+public:
+
+    MapIndex( size_t maxSize );
+
+    slot_t find( T_id ) const;
+    void insert( T_id, slot_t );
+    void reserve( size_t maxSize );
+    void erase( T_id );
+    // Nodes are found only by probing, so nothing is prefetched.
+    void prefetch( T_id ) const {}
+};
+
+// Elements are stored in one array, so slots are allocated only in ctor.
+template <typename T>
+class FlatValues
+{
+    std::vector<std::optional<T>> values_;
+
+public:
+
+    FlatValues( size_t capacity );
+
+    void reserve( size_t capacity );
+    template <typename... Args>
+    T& emplace( slot_t, Args&&... );
+    T& get( slot_t );
+    const T& get( slot_t ) const;
+    void destroy( slot_t );
+};
+
+// Each element is allocated separately, for big elements: slots array
+// stays small & elements are never moved.
+template <typename T>
+class NodeValues
+{
+    std::vector<std::unique_ptr<T>> values_;
+
+public:
+
+    NodeValues( size_t capacity );
+
+    void reserve( size_t capacity );
+    template <typename... Args>
+    T& emplace( slot_t, Args&&... );
+    T& get( slot_t );
+    const T& get( slot_t ) const;
+    void destroy( slot_t );
+};
+
+// Max size of element to be stored in FlatValues by default.
+constexpr size_t MAX_FLAT_VALUE_SIZE = 64;
+
+template <typename T>
+using DefaultValues = std::conditional_t<std::is_trivially_copyable_v<T> && sizeof (T) <= MAX_FLAT_VALUE_SIZE,
+                                         FlatValues<T>, NodeValues<T>>;
+
+// Cache for one thread: no locking at all.
+struct SingleThreaded
+{
+    struct Lock {};
+
+    static constexpr bool IS_THREAD_SAFE = false;
+    Lock lock() const { return {}; }
+};
+
+// Each cache call is done under one mutex.
+class Locked
+{
+    mutable std::mutex mutex_;
+
+public:
+
+    static constexpr bool IS_THREAD_SAFE = true;
+    std::unique_lock<std::mutex> lock() const { return std::unique_lock<std::mutex> {mutex_}; }
+};
+
+// Cache composed from policies (see above), without virtual calls.
+// Thread safe cache returns copies of elements, others return references.
+template <typename T, typename T_id,
+          typename Eviction = LruEviction,
+          typename Index = FlatIndex<T_id>,
+          typename Values = DefaultValues<T>,
+          typename Concurrency = SingleThreaded>
+class PolicyCache
+{
+    using ElemRef = std::conditional_t<Concurrency::IS_THREAD_SAFE, T, const T&>;
+
+    // Public const for users to know.
+public: static constexpr size_t MIN_CAPACITY_ = Eviction::MIN_CAPACITY;
+private:
+
+    Eviction eviction_;
+    Index index_;
+    Values values_;
+    // Ids of elements in slots.
+    std::vector<T_id> ids_;
+    // The last one is taken for new element.
+    std::vector<slot_t> freeSlots_;
+
+    // TinyLFU admission filter: accesses frequencies of all requested ids.
+    // Empty if filter is off.
+    std::optional<FrequencySketch<T_id>> sketch_;
+    // Last loaded element rejected by admission filter.
+    std::optional<T> bypassed_;
+
+    CacheMetrics metrics_;
+    // Called for evicted elements. Empty by default.
+    std::function<void( T_id, T&& )> evictHandler_;
+
+    Concurrency concurrency_;
+
+    // Ids number to load at once from snapshot without elements.
+    static constexpr size_t SNAPSHOT_CHUNK_ = 4096;
+
+    // Calls below are not locked.
+
+    // Returns NIL_SLOT for not cached element. Counts hit or miss.
+    slot_t lookup( T_id );
+    // addLoaded without lock.
+    const T& insert( T_id, T );
+    // Places uncached element constructed from args to cache.
+    // With admission filter element is not cached if it is accessed
+    // less often than the element to be evicted for it.
+    template <typename... Args>
+    const T& load2Cache( T_id, Args&&... args );
+    // Constructs element in free slot, eviction policy is not notified.
+    template <typename... Args>
+    slot_t emplace( T_id, Args&&... args );
+    // Passes element to evict handler & removes it.
+    void evict( slot_t );
+    // Destroys element & frees its slot.
+    void remove( slot_t );
+
+public:
+    // capacity = number of elements that can be cached in memory.
+    // But there is minimum capacity value.
+    // admissionFilter turns on TinyLFU admission filter: it keeps scans &
+    // one-hit ids out of cache for about 8 bytes per element.
+    PolicyCache( size_t capacity, bool admissionFilter = false );
+
+   ~PolicyCache() = default;
+    // Locked caches cannot be copied or moved, caches with NodeValues cannot be copied.
+    PolicyCache( const PolicyCache& ) = default;
+    PolicyCache( PolicyCache&& ) = default;
+    PolicyCache& operator=( const PolicyCache& ) = default;
+    PolicyCache& operator=( PolicyCache&& ) = default;
+
+    // Searches element by it's id. Caches frequiently accessed elements.
+    // Reference is valid until next cache modification.
+    ElemRef getElem( T_id );
+    // Batch version of getElem: elems[i] = getElem (ids[i]).
+    // Memory for ids is prefetched before lookups, all misses of the batch are
+    // loaded with one load (missIds, missNum) call returning std::vector<T>.
+    // So missed elements are placed to cache after hit ones.
+    template <typename BatchLoad = LoadEach<T, T_id>>
+    void getElems( const T_id * ids, size_t idsNum, T * elems, BatchLoad load = {} );
+
+    // getElem without loading: returns nullptr for not cached element.
+    // Pointer is valid until next cache modification.
+    const T * findElem( T_id );
+    // Caches element loaded outside. Does nothing if element is already cached.
+    // Element is moved to cache. Returns cached element, reference is valid
+    // until next cache modification.
+    ElemRef addLoaded( T_id, T );
+    // Forces element caching: cached element with the same id is replaced.
+    // Element is moved to cache.
+    void addElem( EnId<T, T_id> );
+    // Registers time of element loaded outside in metrics.
+    void addLoadTime( std::chrono::nanoseconds );
+    // handler (id, elem) gets each evicted element before its destruction,
+    // e.g. to spill it to lower cache tier. Elements rejected by admission
+    // filter & replaced by addElem are not passed.
+    void setEvictHandler( std::function<void( T_id, T&& )> );
+
+    // To check if element cached.
+    bool isCached( T_id ) const;
+    size_t size() const;
+
+    // Can be called from any thread, even when cache is used in other one.
+    CacheMetrics::Snapshot getMetrics() const;
+
+    // For segmented eviction only.
+    // Saves ids order of all segments to file (see cache-snapshot.hh).
+    // withValues = save elements too, T should be trivially copyable.
+    // Returns false on failure.
+    bool saveSnapshot( const char * filename, bool withValues = false ) const;
+    // Rebuilds cache from mapped snapshot file, so cache is warm after restart.
+    // Cache should be empty. Elements are taken from snapshot if it has them,
+    // otherwise they are loaded in chunks with load (ids, idsNum) returning
+    // std::vector<T> (see getElems). If snapshot segment does not fit in
+    // segment of this cache, only its most recent elements are loaded.
+    // Returns false on failure.
+    template <typename BatchLoad = LoadEach<T, T_id>>
+    bool loadSnapshot( const char * filename, BatchLoad load = {} );
+};
+
+} // namespace caches
+
+#include "cache-policy-impl.hh"
+
+#endif // #ifndef CACHE_POLICY_HH_INCL
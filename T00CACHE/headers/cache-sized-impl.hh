@@ -0,0 +1,192 @@
+#ifndef CACHE_SIZED_IMPL_HH_INCL
+#define CACHE_SIZED_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T>
+size_t ElemCost<T>::getSize( const T& )
+{
+    return sizeof (T);
+}
+
+template <typename T>
+double ElemCost<T>::getCost( const T& )
+{
+    return 1;
+}
+
+template <typename T, typename T_id>
+GdsStore<T, T_id>::GdsStore( size_t bytesCapacity ) :
+    bytesCapacity_ (bytesCapacity)
+{}
+
+template <typename T, typename T_id>
+size_t GdsStore<T, T_id>::getCachedBytes() const
+{
+    return cachedBytes_;
+}
+
+template <typename T, typename T_id>
+typename GdsStore<T, T_id>::OrderKey GdsStore<T, T_id>::getKey( T_id id, const Entry& entry )
+{
+    return OrderKey {entry.priority_, entry.tick_, id};
+}
+
+template <typename T, typename T_id>
+const T * GdsStore<T, T_id>::find( T_id id )
+{
+    auto hashIt = hashTable_.find (id);
+    if (hashIt == hashTable_.end ())
+        return nullptr;
+
+    Entry& entry = hashIt->second;
+
+    priorityOrder_.erase (getKey (id, entry));
+    entry.priority_ = inflation_ + entry.cost_ / std::max<size_t> (entry.size_, 1);
+    entry.tick_ = ++tick_;
+    priorityOrder_.insert (getKey (id, entry));
+
+    return &entry.elem_;
+}
+
+template <typename T, typename T_id>
+void GdsStore<T, T_id>::add( T_id id, const T& elem )
+{
+    assert (hashTable_.find (id) == hashTable_.end ());
+
+    size_t size = ElemCost<T>::getSize (elem);
+    if (size > bytesCapacity_)
+        return;
+
+    while (cachedBytes_ + size > bytesCapacity_)
+    {
+        auto victimIt = priorityOrder_.begin ();
+        auto victimHashIt = hashTable_.find (std::get<T_id> (*victimIt));
+
+        inflation_ = std::get<double> (*victimIt);
+        cachedBytes_ -= victimHashIt->second.size_;
+
+        hashTable_.erase (victimHashIt);
+        priorityOrder_.erase (victimIt);
+    }
+
+    double cost = ElemCost<T>::getCost (elem);
+    Entry entry {elem, size, cost, inflation_ + cost / std::max<size_t> (size, 1), ++tick_};
+
+    priorityOrder_.insert (getKey (id, entry));
+    hashTable_.emplace (id, std::move (entry));
+    cachedBytes_ += size;
+}
+
+template <typename T, typename T_id>
+SizedCacheLRU<T, T_id>::SizedCacheLRU( size_t bytesCapacity ) :
+    store_ (bytesCapacity)
+{}
+
+template <typename T, typename T_id>
+T SizedCacheLRU<T, T_id>::getElem( T_id id )
+{
+    if (const T * cached = store_.find (id))
+        return *cached;
+
+    T elem {id};
+    store_.add (id, elem);
+
+    return elem;
+}
+
+template <typename T, typename T_id>
+SizedCache2Q<T, T_id>::SizedCache2Q( size_t bytesCapacity, size_t pageBytes ) :
+    pageBytes_ (std::max<size_t> (pageBytes, 1)),
+    amCapacity_ (std::max<size_t>
+        (std::trunc (AM_QUOTA_ * (bytesCapacity / pageBytes_)), MIN_AM_CAPACITY_)),
+    alinCapacity_ (std::max<size_t>
+        (std::trunc (ALIN_QUOTA_ * (bytesCapacity / pageBytes_)), MIN_ALIN_CAPACITY_)),
+    aloutCapacity_ (std::max<size_t>
+        (bytesCapacity / pageBytes_ > amCapacity_ + alinCapacity_ ?
+             bytesCapacity / pageBytes_ - amCapacity_ - alinCapacity_ : 0,
+         MIN_ALOUT_CAPACITY_)),
+    am_ (amCapacity_ * pageBytes_),
+    storage_ (alinCapacity_ + aloutCapacity_)
+{}
+
+template <typename T, typename T_id>
+size_t SizedCache2Q<T, T_id>::getCapacity( Segment seg ) const
+{
+    return seg == ALIN ? alinCapacity_ : aloutCapacity_;
+}
+
+template <typename T, typename T_id>
+bool SizedCache2Q<T, T_id>::fits( Segment seg, size_t size ) const
+{
+    return size <= getCapacity (seg) * pageBytes_;
+}
+
+template <typename T, typename T_id>
+void SizedCache2Q<T, T_id>::free( Segment seg, size_t size )
+{
+    while (storage_.size (seg) >= getCapacity (seg) ||
+           cachedBytes_[seg] + size > getCapacity (seg) * pageBytes_)
+    {
+        slot_t tail = storage_.back (seg);
+        size_t tailSize = ElemCost<T>::getSize (storage_.elem (tail));
+        cachedBytes_[seg] -= tailSize;
+
+        if (seg == ALIN && fits (ALOUT, tailSize))
+        {
+            free (ALOUT, tailSize);
+            storage_.splice2Front (ALIN, tail, ALOUT);
+            cachedBytes_[ALOUT] += tailSize;
+        }
+        else
+            storage_.erase (seg, tail);
+    }
+}
+
+template <typename T, typename T_id>
+T SizedCache2Q<T, T_id>::getElem( T_id id )
+{
+    if (const T * cached = am_.find (id))
+        return *cached;
+
+    slot_t aloutSlot = storage_.find (ALOUT, id);
+    // Move element form alout to am.
+    if (aloutSlot != NIL_SLOT)
+    {
+        T elem = std::move (storage_.elem (aloutSlot));
+
+        cachedBytes_[ALOUT] -= ElemCost<T>::getSize (elem);
+        storage_.erase (ALOUT, aloutSlot);
+
+        am_.add (id, elem);
+
+        return elem;
+    }
+
+    slot_t alinSlot = storage_.find (ALIN, id);
+    // Do nothing.
+    if (alinSlot != NIL_SLOT)
+        return storage_.elem (alinSlot);
+
+    // Element isn't cached => load element to the head of alin,
+    // elements evicted from alin go to alout. Too big for alin element
+    // goes to alout directly.
+    T elem {id};
+    size_t size = ElemCost<T>::getSize (elem);
+
+    for (Segment seg : {ALIN, ALOUT})
+        if (fits (seg, size))
+        {
+            free (seg, size);
+            storage_.emplaceFront (seg, id, elem);
+            cachedBytes_[seg] += size;
+            break;
+        }
+
+    return elem;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_SIZED_IMPL_HH_INCL
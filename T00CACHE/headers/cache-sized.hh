@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <array>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+#ifndef CACHE_SIZED_HH_INCL
+#define CACHE_SIZED_HH_INCL
+
+#include "cache.hh"
+
+namespace caches {
+
+// Size in bytes & reload cost of cached element.
+// Should be specialized for elements with variable size or cost.
+template <typename T>
+struct ElemCost
+{
+    static size_t getSize( const T& );
+    static double getCost( const T& );
+};
+
+// Byte budgeted elements store with GreedyDual-Size eviction:
+// element priority is L + cost / size, element with min priority is evicted
+// first and L is set to its priority. So large & cheap to reload elements
+// are evicted first, and for equal cost / size it is LRU.
+template <typename T, typename T_id>
+class GdsStore
+{
+    struct Entry
+    {
+        T elem_;
+        size_t size_ = 0;
+        double cost_ = 0;
+        double priority_ = 0;
+        // To order entries with equal priorities by access time.
+        size_t tick_ = 0;
+    };
+
+    using OrderKey = std::tuple<double, size_t, T_id>;
+
+    const size_t bytesCapacity_;
+    size_t cachedBytes_ = 0;
+
+    // Inflation value L.
+    double inflation_ = 0;
+    size_t tick_ = 0;
+
+    std::unordered_map<T_id, Entry> hashTable_;
+    // First element is the next victim.
+    std::set<OrderKey> priorityOrder_;
+
+    static OrderKey getKey( T_id, const Entry& );
+
+public:
+
+    GdsStore( size_t bytesCapacity );
+
+    size_t getCachedBytes() const;
+
+    // Hit: updates element priority. Returns nullptr for not stored element.
+    // Pointer is valid until next store modification.
+    const T * find( T_id );
+    // Id should not be stored. Evicts elements to fit new element.
+    // Element is not stored if it is bigger than the whole store.
+    void add( T_id, const T& );
+};
+
+// LRU cache with capacity in bytes and GreedyDual-Size eviction
+// (see GdsStore). Element size & cost are taken from ElemCost<T>.
+template <typename T, typename T_id>
+class SizedCacheLRU
+{
+    GdsStore<T, T_id> store_;
+
+public:
+
+    SizedCacheLRU( size_t bytesCapacity );
+
+    // Searches element by it's id. Caches frequiently accessed elements.
+    T getElem( T_id );
+};
+
+// 2Q cache with capacity in bytes. ALin & ALout are FIFO lists limited
+// in bytes & in elements number, AM evicts with GreedyDual-Size (see GdsStore).
+template <typename T, typename T_id>
+class SizedCache2Q
+{
+    // FIFO lists - segments of storage.
+    enum Segment : size_t
+    {
+        ALIN,
+        ALOUT,
+
+        SEGMENTS_NUM
+    };
+
+    // Proportions & minimum capacities for lists - the same as in Cache2Q.
+    static constexpr double AM_QUOTA_ = 0.25;
+    static constexpr double ALIN_QUOTA_ = 0.25;
+
+    static constexpr size_t MIN_AM_CAPACITY_ = 1;
+    static constexpr size_t MIN_ALIN_CAPACITY_ = 1;
+    static constexpr size_t MIN_ALOUT_CAPACITY_ = 2;
+
+    // Lists capacities in pages. List bytes capacity is pages number * pageBytes_,
+    // FIFO list elements number is also limited with pages number.
+    const size_t pageBytes_;
+    const size_t amCapacity_;
+    const size_t alinCapacity_;
+    const size_t aloutCapacity_;
+
+    GdsStore<T, T_id> am_;
+    // ALin & ALout share one slots pool allocated in ctor.
+    FlatStorage<T, T_id, SEGMENTS_NUM> storage_;
+    std::array<size_t, SEGMENTS_NUM> cachedBytes_ {};
+
+    size_t getCapacity( Segment ) const;
+    // Element can be placed in empty FIFO list.
+    bool fits( Segment, size_t size ) const;
+    // Evicts FIFO list tail elements until element of given size can be placed.
+    // Elements evicted from ALin go to ALout.
+    void free( Segment, size_t size );
+
+public:
+
+    // Lists capacities are Cache2Q ones for bytesCapacity / pageBytes elements,
+    // so for elements of pageBytes size hits are the same as Cache2Q hits.
+    SizedCache2Q( size_t bytesCapacity, size_t pageBytes = sizeof (T) );
+
+    // Searches element by it's id. Caches frequiently accessed elements.
+    T getElem( T_id );
+};
+
+} // namespace caches
+
+#include "cache-sized-impl.hh"
+
+#endif // #ifndef CACHE_SIZED_HH_INCL
@@ -0,0 +1,71 @@
+#ifndef CACHE_SKETCH_IMPL_HH_INCL
+#define CACHE_SKETCH_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T_id>
+FrequencySketch<T_id>::FrequencySketch( size_t elemsNum ) :
+    sampleSize_ (SAMPLE_FACTOR_ * std::max<size_t> (elemsNum, 1))
+{
+    size_t wordsNum = 1;
+    while (wordsNum < elemsNum)
+        wordsNum *= 2;
+
+    table_.resize (wordsNum);
+    mask_ = 16 * wordsNum - 1;
+}
+
+template <typename T_id>
+size_t FrequencySketch<T_id>::getCounterId( T_id id, size_t hashId ) const
+{
+    std::uint64_t hash = (std::hash<T_id> {} (id) + 1) * SEEDS_[hashId];
+
+    return (hash ^ (hash >> 32)) & mask_;
+}
+
+template <typename T_id>
+std::uint64_t FrequencySketch<T_id>::getCount( size_t counterId ) const
+{
+    return (table_[counterId / 16] >> (4 * (counterId % 16))) & MAX_COUNT_;
+}
+
+template <typename T_id>
+void FrequencySketch<T_id>::add( T_id id )
+{
+    for (size_t hashId = 0; hashId < DEPTH_; ++hashId)
+    {
+        size_t counterId = getCounterId (id, hashId);
+
+        if (getCount (counterId) < MAX_COUNT_)
+            table_[counterId / 16] += std::uint64_t {1} << (4 * (counterId % 16));
+    }
+
+    if (++additionsNum_ >= sampleSize_)
+        age ();
+}
+
+template <typename T_id>
+std::uint64_t FrequencySketch<T_id>::estimate( T_id id ) const
+{
+    std::uint64_t count = MAX_COUNT_;
+
+    for (size_t hashId = 0; hashId < DEPTH_; ++hashId)
+        count = std::min (count, getCount (getCounterId (id, hashId)));
+
+    return count;
+}
+
+template <typename T_id>
+void FrequencySketch<T_id>::age()
+{
+    // Shifted out low bit of each counter is masked.
+    for (std::uint64_t& word : table_)
+        word = (word >> 1) & 0x7777777777777777ull;
+
+    additionsNum_ /= 2;
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_SKETCH_IMPL_HH_INCL
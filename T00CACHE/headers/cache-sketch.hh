@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifndef CACHE_SKETCH_HH_INCL
+#define CACHE_SKETCH_HH_INCL
+
+namespace caches {
+
+// Count-min sketch with 4 bit counters to estimate ids access frequencies
+// (TinyLFU). Memory is fixed in ctor: 16 counters (one 64 bit word) per
+// expected element. All counters are halved after SAMPLE_FACTOR_ * elemsNum
+// additions, so frequencies of old accesses fade out.
+template <typename T_id>
+class FrequencySketch
+{
+    // Counters per id - one from each hash function.
+    static constexpr size_t DEPTH_ = 4;
+    static constexpr std::array<std::uint64_t, DEPTH_> SEEDS_ =
+        {0xC3A5C85C97CB3127ull, 0xB492B66FBE98F273ull, 0x9AE16A3B2F90404Full, 0xCBF29CE484222325ull};
+
+    static constexpr std::uint64_t MAX_COUNT_ = 15;
+    static constexpr size_t SAMPLE_FACTOR_ = 10;
+
+    // 16 counters in each word.
+    std::vector<std::uint64_t> table_;
+    // Counters number - 1. Counters number is always power of 2.
+    size_t mask_ = 0;
+
+    const size_t sampleSize_;
+    size_t additionsNum_ = 0;
+
+    size_t getCounterId( T_id, size_t hashId ) const;
+    std::uint64_t getCount( size_t counterId ) const;
+
+    // Halves all counters.
+    void age();
+
+public:
+
+    // elemsNum = number of elements to compare frequencies of (cache capacity).
+    FrequencySketch( size_t elemsNum );
+
+    // Registers id access.
+    void add( T_id );
+    // Returns estimated accesses number, but not more than MAX_COUNT_.
+    std::uint64_t estimate( T_id ) const;
+};
+
+} // namespace caches
+
+#include "cache-sketch-impl.hh"
+
+#endif // #ifndef CACHE_SKETCH_HH_INCL
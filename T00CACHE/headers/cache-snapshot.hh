@@ -0,0 +1,35 @@
+#include <cstdint>
+#include <cstring>
+
+#ifndef CACHE_SNAPSHOT_HH_INCL
+#define CACHE_SNAPSHOT_HH_INCL
+
+#include "cache-mapped.hh"
+
+namespace caches {
+
+/* Cache2Q snapshot format (native byte order):
+
+       <HEADER> <AM IDS> [AM ELEMS] <ALIN IDS> [ALIN ELEMS] <ALOUT IDS> [ALOUT ELEMS]
+
+   Header layout is SnapshotHeader. Ids & elements of each segment are stored
+   from the most to the least recent one. Elements are stored only for
+   trivially copyable types (as is), elemSize_ = 0 if they are not stored.
+*/
+struct SnapshotHeader
+{
+    static constexpr char MAGIC[4] = {'C', '2', 'Q', 'S'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t SEGMENTS_NUM = 3;
+
+    char magic_[4] = {};
+    std::uint32_t version_ = 0;
+    std::uint32_t idSize_ = 0;
+    std::uint32_t elemSize_ = 0;
+    std::uint64_t segmentSizes_[SEGMENTS_NUM] = {};
+};
+static_assert (sizeof (SnapshotHeader) == 40, "SnapshotHeader should be packed");
+
+} // namespace caches
+
+#endif // #ifndef CACHE_SNAPSHOT_HH_INCL
@@ -0,0 +1,353 @@
+#ifndef CACHE_STORAGE_IMPL_HH_INCL
+#define CACHE_STORAGE_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T_id>
+FlatIndex<T_id>::FlatIndex( size_t maxSize )
+{
+    // Load factor is kept <= 0.5 for short probe sequences.
+    size_t bucketsNum = 2;
+    while (bucketsNum < 2 * maxSize)
+        bucketsNum *= 2;
+
+    buckets_.resize (bucketsNum);
+    mask_ = bucketsNum - 1;
+}
+
+template <typename T_id>
+size_t FlatIndex<T_id>::home( T_id id ) const
+{
+    // std::hash is identity for integers, so bits are mixed (Fibonacci hashing).
+    std::uint64_t hash = std::hash<T_id> {} (id);
+    hash *= 0x9E3779B97F4A7C15ull;
+
+    return (hash ^ (hash >> 32)) & mask_;
+}
+
+template <typename T_id>
+slot_t FlatIndex<T_id>::find( T_id id ) const
+{
+    for (size_t pos = home (id);; pos = (pos + 1) & mask_)
+    {
+        const Bucket& bucket = buckets_[pos];
+
+        if (bucket.slot_ == NIL_SLOT)
+            return NIL_SLOT;
+        if (bucket.id_ == id)
+            return bucket.slot_;
+    }
+}
+
+template <typename T_id>
+void FlatIndex<T_id>::insert( T_id id, slot_t slot )
+{
+    assert (find (id) == NIL_SLOT);
+
+    size_t pos = home (id);
+    while (buckets_[pos].slot_ != NIL_SLOT)
+        pos = (pos + 1) & mask_;
+
+    buckets_[pos] = Bucket {id, slot};
+}
+
+template <typename T_id>
+void FlatIndex<T_id>::reserve( size_t maxSize )
+{
+    if (buckets_.size () >= 2 * maxSize)
+        return;
+
+    std::vector<Bucket> oldBuckets = std::move (buckets_);
+    *this = FlatIndex {maxSize};
+
+    for (const Bucket& bucket : oldBuckets)
+        if (bucket.slot_ != NIL_SLOT)
+            insert (bucket.id_, bucket.slot_);
+}
+
+template <typename T_id>
+void FlatIndex<T_id>::erase( T_id id )
+{
+    size_t pos = home (id);
+    for (; buckets_[pos].slot_ != NIL_SLOT; pos = (pos + 1) & mask_)
+        if (buckets_[pos].id_ == id)
+            break;
+
+    if (buckets_[pos].slot_ == NIL_SLOT)
+        return;
+
+    // Backward shift deletion - no tombstones are left.
+    for (size_t next = (pos + 1) & mask_;; next = (next + 1) & mask_)
+    {
+        Bucket& nextBucket = buckets_[next];
+        if (nextBucket.slot_ == NIL_SLOT)
+            break;
+
+        // Bucket can be shifted to pos only if pos is in [home, next) cyclic range.
+        size_t nextHome = home (nextBucket.id_);
+        if (((next - nextHome) & mask_) >= ((next - pos) & mask_))
+        {
+            buckets_[pos] = nextBucket;
+            pos = next;
+        }
+    }
+
+    buckets_[pos].slot_ = NIL_SLOT;
+}
+
+template <typename T_id>
+void FlatIndex<T_id>::prefetch( T_id id ) const
+{
+    __builtin_prefetch (&buckets_[home (id)]);
+}
+
+template <size_t LISTS_NUM>
+SlotLists<LISTS_NUM>::SlotLists( size_t slotsNum ) :
+    links_ (slotsNum)
+{
+    assert (slotsNum < NIL_SLOT);
+}
+
+template <size_t LISTS_NUM>
+size_t SlotLists<LISTS_NUM>::slotsNum() const
+{
+    return links_.size ();
+}
+
+template <size_t LISTS_NUM>
+void SlotLists<LISTS_NUM>::reserve( size_t slotsNum )
+{
+    assert (slotsNum < NIL_SLOT);
+
+    if (slotsNum > links_.size ())
+        links_.resize (slotsNum);
+}
+
+template <size_t LISTS_NUM>
+size_t SlotLists<LISTS_NUM>::size( size_t listId ) const
+{
+    return lists_[listId].size_;
+}
+
+template <size_t LISTS_NUM>
+slot_t SlotLists<LISTS_NUM>::front( size_t listId ) const
+{
+    return lists_[listId].head_;
+}
+
+template <size_t LISTS_NUM>
+slot_t SlotLists<LISTS_NUM>::back( size_t listId ) const
+{
+    return lists_[listId].tail_;
+}
+
+template <size_t LISTS_NUM>
+slot_t SlotLists<LISTS_NUM>::next( slot_t slot ) const
+{
+    return links_[slot].next_;
+}
+
+template <size_t LISTS_NUM>
+void SlotLists<LISTS_NUM>::link2Front( size_t listId, slot_t slot )
+{
+    List& list = lists_[listId];
+    Links& links = links_[slot];
+
+    links.prev_ = NIL_SLOT;
+    links.next_ = list.head_;
+
+    if (list.head_ != NIL_SLOT)
+        links_[list.head_].prev_ = slot;
+    else
+        list.tail_ = slot;
+
+    list.head_ = slot;
+    ++list.size_;
+}
+
+template <size_t LISTS_NUM>
+void SlotLists<LISTS_NUM>::unlink( size_t listId, slot_t slot )
+{
+    List& list = lists_[listId];
+    Links& links = links_[slot];
+
+    if (links.prev_ != NIL_SLOT)
+        links_[links.prev_].next_ = links.next_;
+    else
+        list.head_ = links.next_;
+
+    if (links.next_ != NIL_SLOT)
+        links_[links.next_].prev_ = links.prev_;
+    else
+        list.tail_ = links.prev_;
+
+    links = Links {};
+    --list.size_;
+}
+
+template <size_t LISTS_NUM>
+void SlotLists<LISTS_NUM>::move2Front( size_t listId, slot_t slot )
+{
+    if (lists_[listId].head_ == slot)
+        return;
+
+    unlink (listId, slot);
+    link2Front (listId, slot);
+}
+
+template <size_t LISTS_NUM>
+void SlotLists<LISTS_NUM>::splice2Front( size_t fromListId, slot_t slot, size_t toListId )
+{
+    unlink (fromListId, slot);
+    link2Front (toListId, slot);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+FlatStorage<T, T_id, SEGMENTS_NUM>::FlatStorage( size_t capacity ) :
+    nodes_ (capacity),
+    lists_ (capacity)
+{
+    // Free slots are taken from 0.
+    for (slot_t slot = capacity; slot-- > 0;)
+        lists_.link2Front (FREE_LIST_, slot);
+
+    for (FlatIndex<T_id>& index : indexes_)
+        index = FlatIndex<T_id> {capacity};
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+size_t FlatStorage<T, T_id, SEGMENTS_NUM>::capacity() const
+{
+    return nodes_.size ();
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+void FlatStorage<T, T_id, SEGMENTS_NUM>::reserve( size_t capacity )
+{
+    size_t oldCapacity = nodes_.size ();
+    if (capacity <= oldCapacity)
+        return;
+
+    nodes_.resize (capacity);
+    lists_.reserve (capacity);
+
+    // New slots are linked before old free ones.
+    for (slot_t slot = capacity; slot-- > oldCapacity;)
+        lists_.link2Front (FREE_LIST_, slot);
+
+    for (FlatIndex<T_id>& index : indexes_)
+        index.reserve (capacity);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+bool FlatStorage<T, T_id, SEGMENTS_NUM>::isFull() const
+{
+    return lists_.size (FREE_LIST_) == 0;
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+size_t FlatStorage<T, T_id, SEGMENTS_NUM>::size( size_t segId ) const
+{
+    return lists_.size (segId);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+slot_t FlatStorage<T, T_id, SEGMENTS_NUM>::front( size_t segId ) const
+{
+    return lists_.front (segId);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+slot_t FlatStorage<T, T_id, SEGMENTS_NUM>::back( size_t segId ) const
+{
+    return lists_.back (segId);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+slot_t FlatStorage<T, T_id, SEGMENTS_NUM>::next( slot_t slot ) const
+{
+    return lists_.next (slot);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+slot_t FlatStorage<T, T_id, SEGMENTS_NUM>::find( size_t segId, T_id id ) const
+{
+    return indexes_[segId].find (id);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+T& FlatStorage<T, T_id, SEGMENTS_NUM>::elem( slot_t slot )
+{
+    return *nodes_[slot].elem_;
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+const T& FlatStorage<T, T_id, SEGMENTS_NUM>::elem( slot_t slot ) const
+{
+    return *nodes_[slot].elem_;
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+T_id FlatStorage<T, T_id, SEGMENTS_NUM>::id( slot_t slot ) const
+{
+    return nodes_[slot].id_;
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+template <typename... Args>
+slot_t FlatStorage<T, T_id, SEGMENTS_NUM>::emplaceFront( size_t segId, T_id id, Args&&... args )
+{
+    assert (!isFull ());
+
+    slot_t slot = lists_.front (FREE_LIST_);
+    Node& node = nodes_[slot];
+
+    node.elem_.emplace (std::forward<Args> (args)...);
+    node.id_ = id;
+
+    lists_.splice2Front (FREE_LIST_, slot, segId);
+    indexes_[segId].insert (id, slot);
+
+    return slot;
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+void FlatStorage<T, T_id, SEGMENTS_NUM>::move2Front( size_t segId, slot_t slot )
+{
+    lists_.move2Front (segId, slot);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+void FlatStorage<T, T_id, SEGMENTS_NUM>::splice2Front( size_t fromSegId, slot_t slot, size_t toSegId )
+{
+    T_id id = nodes_[slot].id_;
+
+    lists_.splice2Front (fromSegId, slot, toSegId);
+    indexes_[fromSegId].erase (id);
+    indexes_[toSegId].insert (id, slot);
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+void FlatStorage<T, T_id, SEGMENTS_NUM>::erase( size_t segId, slot_t slot )
+{
+    Node& node = nodes_[slot];
+
+    lists_.splice2Front (segId, slot, FREE_LIST_);
+    indexes_[segId].erase (node.id_);
+
+    node.elem_.reset ();
+}
+
+template <typename T, typename T_id, size_t SEGMENTS_NUM>
+void FlatStorage<T, T_id, SEGMENTS_NUM>::prefetch( const T_id * ids, size_t idsNum ) const
+{
+    // All bucket loads are in flight before the first probe.
+    for (size_t i = 0; i < idsNum; ++i)
+        for (const FlatIndex<T_id>& index : indexes_)
+            index.prefetch (ids[i]);
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_STORAGE_IMPL_HH_INCL
@@ -0,0 +1,174 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifndef CACHE_STORAGE_HH_INCL
+#define CACHE_STORAGE_HH_INCL
+
+namespace caches {
+
+// Index of element slot in preallocated storage.
+using slot_t = std::uint32_t;
+// Used as null link and as empty bucket mark.
+constexpr slot_t NIL_SLOT = ~slot_t {0};
+// Ids number to prefetch memory for at once in batch lookups.
+// Bigger chunks can evict prefetched lines before they are used.
+constexpr size_t PREFETCH_CHUNK = 16;
+
+// Open addressing (linear probing) hash table: id -> slot.
+// All buckets are allocated in ctor, so insert & erase never allocate.
+template <typename T_id>
+class FlatIndex
+{
+    struct Bucket
+    {
+        T_id id_ {};
+        slot_t slot_ = NIL_SLOT;
+    };
+
+    std::vector<Bucket> buckets_;
+    // buckets_.size () - 1. Buckets number is always power of 2.
+    size_t mask_ = 0;
+
+    size_t home( T_id ) const;
+
+public:
+
+    // maxSize = max number of simultaneously stored ids.
+    FlatIndex( size_t maxSize = 0 );
+
+    // Returns NIL_SLOT for not stored ids.
+    slot_t find( T_id ) const;
+    // Id should not be stored.
+    void insert( T_id, slot_t );
+    // Rehashes stored ids if there are not enough buckets for maxSize ids.
+    void reserve( size_t maxSize );
+    // Does nothing for not stored ids.
+    void erase( T_id );
+
+    // Hint to load bucket where id probing starts to cache.
+    void prefetch( T_id ) const;
+};
+
+// Double linked lists of slots with index based links. Each slot is
+// linked to one list at most. Lists keep only links, so elements are kept
+// by their owner: FlatStorage or eviction policy of PolicyCache.
+template <size_t LISTS_NUM>
+class SlotLists
+{
+    struct Links
+    {
+        slot_t prev_ = NIL_SLOT;
+        slot_t next_ = NIL_SLOT;
+    };
+
+    struct List
+    {
+        slot_t head_ = NIL_SLOT;
+        slot_t tail_ = NIL_SLOT;
+        size_t size_ = 0;
+    };
+
+    std::vector<Links> links_;
+    std::array<List, LISTS_NUM> lists_;
+
+public:
+
+    // Slots [0, slotsNum) are not linked to any list.
+    SlotLists( size_t slotsNum = 0 );
+
+    size_t slotsNum() const;
+    // Adds not linked slots up to slotsNum.
+    void reserve( size_t slotsNum );
+
+    size_t size( size_t listId ) const;
+    // Return NIL_SLOT for empty list.
+    slot_t front( size_t listId ) const;
+    slot_t back( size_t listId ) const;
+    // Next slot from head to tail of list. NIL_SLOT for tail.
+    slot_t next( slot_t ) const;
+
+    // Slot should not be linked.
+    void link2Front( size_t listId, slot_t );
+    void unlink( size_t listId, slot_t );
+    void move2Front( size_t listId, slot_t );
+    void splice2Front( size_t fromListId, slot_t, size_t toListId );
+};
+
+// Preallocated storage for elements, splitted in SEGMENTS_NUM segments.
+// Each segment is a slots list with its own FlatIndex. All segments share
+// one slots pool, free slots are one more list.
+//
+// Slots are allocated only in ctor, so steady-state work with
+// storage does not allocate at all.
+template <typename T, typename T_id, size_t SEGMENTS_NUM = 1>
+class FlatStorage
+{
+    struct Node
+    {
+        // Empty for free slots.
+        std::optional<T> elem_;
+        T_id id_ {};
+    };
+
+    // Id of free slots list.
+    static constexpr size_t FREE_LIST_ = SEGMENTS_NUM;
+
+    std::vector<Node> nodes_;
+    SlotLists<SEGMENTS_NUM + 1> lists_;
+    std::array<FlatIndex<T_id>, SEGMENTS_NUM> indexes_;
+
+public:
+
+    // capacity = total number of slots for all segments.
+    FlatStorage( size_t capacity );
+
+    // Total number of slots.
+    size_t capacity() const;
+    // Adds free slots up to capacity. Stored elements keep their slots.
+    void reserve( size_t capacity );
+    bool isFull() const;
+
+    size_t size( size_t segId ) const;
+    // Return NIL_SLOT for empty segment.
+    slot_t front( size_t segId ) const;
+    slot_t back( size_t segId ) const;
+    // Next slot from head to tail of segment. NIL_SLOT for tail.
+    slot_t next( slot_t ) const;
+
+    // Returns NIL_SLOT if element is not stored in segment.
+    slot_t find( size_t segId, T_id ) const;
+
+    T& elem( slot_t );
+    const T& elem( slot_t ) const;
+    T_id id( slot_t ) const;
+
+    // Constructs new element in the head of segment.
+    // Storage should not be full. Id should not be stored in segment.
+    template <typename... Args>
+    slot_t emplaceFront( size_t segId, T_id id, Args&&... args );
+
+    // Moves stored element to the head of its segment.
+    void move2Front( size_t segId, slot_t );
+    // Moves stored element to the head of other segment.
+    // Element is not copied.
+    void splice2Front( size_t fromSegId, slot_t, size_t toSegId );
+
+    // Destroys stored element and frees its slot.
+    void erase( size_t segId, slot_t );
+
+    // Hint to load buckets of all segments indexes for ids to cache.
+    // Nodes are not prefetched: their slots are known only after probing,
+    // and the caller probes anyway.
+    void prefetch( const T_id * ids, size_t idsNum ) const;
+};
+
+} // namespace caches
+
+#include "cache-storage-impl.hh"
+
+#endif // #ifndef CACHE_STORAGE_HH_INCL
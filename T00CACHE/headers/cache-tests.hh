@@ -1,11 +1,17 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 
 #ifndef CACHE_TESTS_HH_INCL
 #define CACHE_TESTS_HH_INCL
 
 #include "cache.hh"
+#include "cache-concurrent.hh"
+#include "cache-policy.hh"
+#include "cache-sized.hh"
+#include "cache-tiered.hh"
+#include "cache-ttl.hh"
 
 namespace caches
 {
@@ -28,6 +34,65 @@ public:
 
 };
 
+// Test page with per id size & reload cost, for byte budgeted caches.
+// Ids without set params have PAGE_SIZE_ size and unit cost.
+class SizedTestPage
+{
+public:
+    static const size_t PAGE_SIZE_ = 64;
+
+private:
+    testPageId_t id_ = 0;
+
+    static std::unordered_map<testPageId_t, std::pair<size_t, double>> params_;
+    static size_t missCounter_;
+    static size_t missedBytes_;
+
+public:
+
+    SizedTestPage( testPageId_t );
+    testPageId_t getId() const;
+
+    static void setParams( testPageId_t, size_t size, double cost );
+    static void resetParams();
+    static size_t getSize( testPageId_t );
+    static double getCost( testPageId_t );
+
+    static void resetMissNum();
+    static size_t getMissNum();
+    static size_t getMissedBytes();
+};
+
+template <>
+struct ElemCost<SizedTestPage>
+{
+    static size_t getSize( const SizedTestPage& page ) { return SizedTestPage::getSize (page.getId ()); }
+    static double getCost( const SizedTestPage& page ) { return SizedTestPage::getCost (page.getId ()); }
+};
+
+// Requests sequence for cache efficiency tests.
+struct TestTrace
+{
+    size_t cacheSize_ = 0;
+    std::vector<testPageId_t> ids_;
+};
+
+// Reads trace in format:
+//     <CACHE CAPACITY> <SEQUENCE SIZE> <SEQUENCE>
+TestTrace readTrace( std::istream& in );
+
+// Returns number of hits for given cache & requests sequence.
+template <typename Cache>
+size_t countHits( Cache& cache, const testPageId_t * ids, size_t idsNum )
+{
+    TestPage::resetMissNum ();
+
+    for (size_t i = 0; i < idsNum; ++i)
+        cache.getElem (ids[i]);
+
+    return idsNum - TestPage::getMissNum ();
+}
+
 // 2Q Efficiency tests stuff.
     // To test with data from stdin. Format for data:
     //     <CACHE CAPACITY> <SEQUENCE SIZE> <SEQUENCE>
@@ -41,6 +106,156 @@ public:
     //     Prints test result in stdin.
     void test2QEfficiency( const char * filename );
 
+    // Converts the same file to binary trace, maps it & tests with it.
+    //
+    //     Prints test result in stdin.
+    void testBinTrace( const char * filename );
+
+    // Cmps CLOCK hits with reference CLOCK model hits on the same file.
+    // Expected number of hits in file is not used.
+    //
+    //     Prints test result in stdin.
+    void testClockParity( const char * filename );
+
+    // Cmps adaptive 2Q hits with 2Q hits on the same file: tuning should
+    // not lose hits. Expected number of hits in file is not used.
+    //
+    //     Prints test result in stdin.
+    void testAdaptive2Q( const char * filename );
+
+    // Saves 2Q cache warmed with file sequence to snapshot (with & without
+    // elements), loads it to new caches & cmps hits of all caches on
+    // the same sequence rerun.
+    //
+    //     Prints test result in stdin.
+    void testSnapshot( const char * filename );
+
+    // Cmps OPT hits with LRU & 2Q hits on the same file: OPT hits should
+    // not be below them. Expected number of hits in file is not used.
+    //
+    //     Prints test result in stdin.
+    void testBelady( const char * filename );
+
+    // Cmps LRU hits got from stack distances (see cache-mrc.hh) with
+    // CacheLRU hits on the same file for each capacity up to file one.
+    //
+    //     Prints test result in stdin.
+    void testStackDistances( const char * filename );
+
+    // Cmps hits of independent implementations on big binary trace
+    // (see cache-gen-main.cc) with trace capacity: CacheLRU with stack
+    // distances, CacheClock with CLOCK model, Cache2Q with 2Q simulation
+    // of cache-mrc. Adaptive 2Q hits should not be below Cache2Q ones,
+    // OPT hits should not be below LRU & 2Q ones.
+    // Traces have no expected hits.
+    //
+    //     Prints test result in stdin.
+    void testGeneratedTrace( const char * filename );
+
+    // To test with memory mapped binary trace (see cache-trace.hh).
+    //
+    //     Silently returns number of hits.
+    size_t replayBinTrace( const char * filename );
+
+    // Cmps 2Q hits with and without TinyLFU admission filter on
+    // generated Zipf traces with & without scans.
+    //
+    //     Prints test result in stdin.
+    void testAdmissionFilter();
+
+    // Cmps CacheTtlLRU hits with simple LRU list model where expired
+    // elements are found by scan. Generated Zipf trace, time jumps and
+    // per element ttls cover all timing wheel levels.
+    //
+    //     Prints test result in stdin.
+    void testTtl();
+
+    // Runs two tier cache with disk tier big enough for all ids on
+    // generated Zipf trace: each id should be loaded once, and elements
+    // read from disk should be the same as spilled ones.
+    //
+    //     Prints test result in stdin.
+    void testTieredCache();
+
+    // Cmps hits of PolicyCache with LRU, CLOCK & 2Q eviction and different
+    // index, values & concurrency policies with CacheLRU, CacheClock &
+    // Cache2Q hits on generated Zipf trace.
+    //
+    //     Prints test result in stdin.
+    void testPolicyCache();
+
+    // Checks ConcurrentCacheLRU on generated Zipf traces: in one thread
+    // its hits should not be below FIFO ones (recency is applied in
+    // batches), in several threads all got elements should be right.
+    //
+    //     Prints test result in stdin.
+    void testConcurrentCache();
+
+    // On generated Zipf traces with & without scans cmps CLOCK hits with
+    // reference CLOCK model hits & with LRU hits (up to tolerance), and
+    // checks that CLOCK-Pro hits are not below 2Q hits.
+    //
+    //     Prints test result in stdin.
+    void testClockPolicies();
+
+    // Cmps OPT & LRU hits on hand made sequences with known hits.
+    //
+    //     Prints test result in stdin.
+    void testBeladyKnownHits();
+
+    // Runs adaptive 2Q on scan of blocks each read twice, then on loop
+    // over hot set bigger than AM: ALin should grow on scan, AM should grow
+    // on reuse. Stats should be consistent after each request.
+    //
+    //     Prints test result in stdin.
+    void testAdaptiveSplit();
+
+    // Cmps LRU & 2Q getElems with getElem loop on generated Zipf trace:
+    // batches of one should give the same hits, bigger batches should give
+    // the same hits as hits lookups followed by misses loads, all got
+    // elements should be right.
+    //
+    //     Prints test result in stdin.
+    void testBatchLookup();
+
+    // Cmps byte budgeted LRU & 2Q hits with CacheLRU & Cache2Q hits for
+    // the same number of pages on generated Zipf trace of equal pages.
+    //
+    //     Prints test result in stdin.
+    void testSizedCache();
+
+    // Cmps metrics of LRU, 2Q, adaptive 2Q, CLOCK & CLOCK-Pro with hits &
+    // misses on generated Zipf trace, checks json line of known metrics
+    // printed directly & by MetricsDumper.
+    //
+    //     Prints test result in stdin.
+    void testMetrics();
+
+    // Checks ShardedCache2Q on generated Zipf traces: in one thread its
+    // hits should be the same as hits of independent Cache2Q per shard,
+    // in several threads all got elements should be right.
+    //
+    //     Prints test result in stdin.
+    void testShardedCache();
+
+    // Misses the same id in several threads at once: loader should call
+    // backend once & all threads should get its element.
+    //
+    //     Prints test result in stdin.
+    void testAsyncLoader();
+
+    // To cmp OPT, LRU and 2Q with data from stdin. Format for data:
+    //     <CACHE CAPACITY> <SEQUENCE SIZE> <SEQUENCE>
+    //
+    //     Prints hits numbers for all policies in stdout.
+    void cmpEfficiency();
+
+    // To cmp byte budgeted LRU and 2Q with data from stdin. Format for data:
+    //     <CACHE BYTES> <SEQUENCE SIZE> <SEQUENCE> <PARAMS NUM> <ID SIZE COST>...
+    //
+    //     Prints hits number, hit rate & byte hit rate for both policies in stdout.
+    void cmpSizedEfficiency();
+
 } // namespace caches
 
 #endif // #ifndef CACHE_TESTS_HH_INCL
\ No newline at end of file
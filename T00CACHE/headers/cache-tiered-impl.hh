@@ -0,0 +1,163 @@
+#ifndef CACHE_TIERED_IMPL_HH_INCL
+#define CACHE_TIERED_IMPL_HH_INCL
+
+namespace caches
+{
+
+template <typename T, typename T_id>
+DiskLog<T, T_id>::DiskLog( const char * filename, size_t capacity ) :
+    fd_ (open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644)),
+    capacity_ (std::max<size_t> (capacity, 1)),
+    slotIds_ (capacity_)
+{
+    assert (filename != nullptr);
+
+    writeBuffer_.reserve (WRITE_BATCH_ * RECORD_SIZE_);
+}
+
+template <typename T, typename T_id>
+DiskLog<T, T_id>::~DiskLog()
+{
+    if (fd_ >= 0)
+        close (fd_);
+}
+
+template <typename T, typename T_id>
+bool DiskLog<T, T_id>::isValid() const
+{
+    return fd_ >= 0;
+}
+
+template <typename T, typename T_id>
+size_t DiskLog<T, T_id>::size() const
+{
+    return index_.size ();
+}
+
+template <typename T, typename T_id>
+void DiskLog<T, T_id>::flush()
+{
+    if (writeBuffer_.empty ())
+        return;
+
+    off_t offset = (bufferBegin_ % capacity_) * RECORD_SIZE_;
+    ssize_t written = pwrite (fd_, writeBuffer_.data (), writeBuffer_.size (), offset);
+
+    if (written != static_cast<ssize_t> (writeBuffer_.size ()))
+        for (std::uint64_t pos = bufferBegin_; pos < end_; ++pos)
+        {
+            auto indexIt = index_.find (slotIds_[pos % capacity_]);
+            if (indexIt != index_.end () && indexIt->second == pos)
+                index_.erase (indexIt);
+        }
+
+    writeBuffer_.clear ();
+    bufferBegin_ = end_;
+}
+
+template <typename T, typename T_id>
+void DiskLog<T, T_id>::append( T_id id, const T& elem )
+{
+    if (!isValid ())
+        return;
+
+    // Drop the oldest record if its slot is reused.
+    size_t slot = end_ % capacity_;
+    if (end_ >= capacity_)
+    {
+        auto indexIt = index_.find (slotIds_[slot]);
+        if (indexIt != index_.end () && indexIt->second == end_ - capacity_)
+            index_.erase (indexIt);
+    }
+
+    const unsigned char * idBytes = reinterpret_cast<const unsigned char *> (&id);
+    const unsigned char * elemBytes = reinterpret_cast<const unsigned char *> (&elem);
+    writeBuffer_.insert (writeBuffer_.end (), idBytes, idBytes + sizeof (T_id));
+    writeBuffer_.insert (writeBuffer_.end (), elemBytes, elemBytes + sizeof (T));
+
+    slotIds_[slot] = id;
+    index_[id] = end_;
+    ++end_;
+
+    // Buffer is written with one write, so it never crosses file end.
+    if (end_ - bufferBegin_ == WRITE_BATCH_ || end_ % capacity_ == 0)
+        flush ();
+}
+
+template <typename T, typename T_id>
+std::optional<T> DiskLog<T, T_id>::take( T_id id )
+{
+    auto indexIt = index_.find (id);
+    if (indexIt == index_.end ())
+        return std::nullopt;
+
+    std::uint64_t pos = indexIt->second;
+    index_.erase (indexIt);
+
+    alignas (T) unsigned char elemBytes[sizeof (T)];
+
+    if (pos >= bufferBegin_)
+        std::memcpy (elemBytes, writeBuffer_.data () + (pos - bufferBegin_) * RECORD_SIZE_ + sizeof (T_id), sizeof (T));
+    else
+    {
+        off_t offset = (pos % capacity_) * RECORD_SIZE_ + sizeof (T_id);
+        if (pread (fd_, elemBytes, sizeof (T), offset) != static_cast<ssize_t> (sizeof (T)))
+            return std::nullopt;
+    }
+
+    return *std::launder (reinterpret_cast<T *> (elemBytes));
+}
+
+template <typename T, typename T_id>
+TieredCache2Q<T, T_id>::TieredCache2Q( size_t memoryCapacity, const char * diskFilename, size_t diskCapacity ) :
+    memory_ (memoryCapacity),
+    disk_ (diskFilename, diskCapacity)
+{
+    memory_.setEvictHandler ([this]( T_id id, T&& elem ) { disk_.append (id, elem); });
+}
+
+template <typename T, typename T_id>
+bool TieredCache2Q<T, T_id>::isValid() const
+{
+    return disk_.isValid ();
+}
+
+template <typename T, typename T_id>
+const T& TieredCache2Q<T, T_id>::getElem( T_id id )
+{
+    if (const T * cached = memory_.findElem (id))
+    {
+        ++stats_.memoryHitsNum_;
+        return *cached;
+    }
+
+    if (std::optional<T> stored = disk_.take (id))
+    {
+        ++stats_.diskHitsNum_;
+        return memory_.addLoaded (id, std::move (*stored));
+    }
+
+    ++stats_.loadsNum_;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+    T loaded (id);
+    memory_.addLoadTime (std::chrono::steady_clock::now () - begin);
+
+    return memory_.addLoaded (id, std::move (loaded));
+}
+
+template <typename T, typename T_id>
+typename TieredCache2Q<T, T_id>::Stats TieredCache2Q<T, T_id>::getStats() const
+{
+    return stats_;
+}
+
+template <typename T, typename T_id>
+CacheMetrics::Snapshot TieredCache2Q<T, T_id>::getMetrics() const
+{
+    return memory_.getMetrics ();
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_TIERED_IMPL_HH_INCL
@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#ifndef CACHE_TIERED_HH_INCL
+#define CACHE_TIERED_HH_INCL
+
+#include "cache.hh"
+
+namespace caches {
+
+// Disk cache tier: log of capacity records in file (a stand-in for SSD)
+// with in-memory index id -> log position of the latest record.
+// Records are appended in batches of WRITE_BATCH_ with one write. When log
+// is full it wraps around: the oldest record slot is overwritten, so
+// the oldest stored element is dropped (FIFO eviction).
+//
+// Record layout: <ID> <ELEM>, both stored as is.
+template <typename T, typename T_id>
+class DiskLog
+{
+    static_assert (std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<T_id>,
+        "Elements & ids are written to file as is");
+
+    static constexpr size_t RECORD_SIZE_ = sizeof (T_id) + sizeof (T);
+    static constexpr size_t WRITE_BATCH_ = 64;
+
+    int fd_ = -1;
+    // Max records number in file.
+    const size_t capacity_;
+
+    // Position of the next appended record. Record with position
+    // pos is in file record slot pos % capacity_.
+    std::uint64_t end_ = 0;
+    std::unordered_map<T_id, std::uint64_t> index_;
+    // Ids of records in file record slots.
+    std::vector<T_id> slotIds_;
+
+    // Not written records with positions from bufferBegin_ to end_.
+    std::vector<unsigned char> writeBuffer_;
+    std::uint64_t bufferBegin_ = 0;
+
+    // Writes buffer to file. Records of failed write are dropped.
+    void flush();
+
+public:
+
+    // File is created or truncated. capacity = max records number in file.
+    DiskLog( const char * filename, size_t capacity );
+
+   ~DiskLog();
+    DiskLog( const DiskLog& ) = delete;
+    DiskLog( DiskLog&& ) = delete;
+    DiskLog& operator=( const DiskLog& ) = delete;
+    DiskLog& operator=( DiskLog&& ) = delete;
+
+    bool isValid() const;
+    // Number of elements stored.
+    size_t size() const;
+
+    // Stores element, previous record of the same id becomes stale.
+    void append( T_id, const T& );
+    // Reads stored element & removes it from log.
+    // Returns empty optional for not stored element or read failure.
+    std::optional<T> take( T_id );
+};
+
+// Two tier cache: Cache2Q in memory & DiskLog on disk.
+// Elements evicted from memory are spilled to disk, elements found
+// on disk are moved back to memory. Each element is stored in one tier.
+// Lookups check memory, then disk, then load element with T (id).
+template <typename T, typename T_id>
+class TieredCache2Q
+{
+public:
+
+    struct Stats
+    {
+        size_t memoryHitsNum_ = 0;
+        size_t diskHitsNum_ = 0;
+        size_t loadsNum_ = 0;
+    };
+
+private:
+
+    Cache2Q<T, T_id> memory_;
+    DiskLog<T, T_id> disk_;
+
+    Stats stats_;
+
+public:
+
+    // diskFilename = file for disk tier, it is created or truncated.
+    TieredCache2Q( size_t memoryCapacity, const char * diskFilename, size_t diskCapacity );
+
+   ~TieredCache2Q() = default;
+    // Memory tier evict handler refers to this cache.
+    TieredCache2Q( const TieredCache2Q& ) = delete;
+    TieredCache2Q( TieredCache2Q&& ) = delete;
+    TieredCache2Q& operator=( const TieredCache2Q& ) = delete;
+    TieredCache2Q& operator=( TieredCache2Q&& ) = delete;
+
+    // Cache works as memory only one if disk tier file cannot be opened.
+    bool isValid() const;
+
+    // Searches element by it's id in memory & on disk, loads missed one.
+    // Reference is valid until next cache modification.
+    const T& getElem( T_id );
+
+    Stats getStats() const;
+    // Memory tier metrics.
+    CacheMetrics::Snapshot getMetrics() const;
+};
+
+} // namespace caches
+
+#include "cache-tiered-impl.hh"
+
+#endif // #ifndef CACHE_TIERED_HH_INCL
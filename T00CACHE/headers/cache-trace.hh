@@ -0,0 +1,73 @@
+#include <cstdint>
+#include <cstdio>
+
+#ifndef CACHE_TRACE_HH_INCL
+#define CACHE_TRACE_HH_INCL
+
+#include "cache-mapped.hh"
+#include "cache-tests.hh"
+
+namespace caches
+{
+
+// Mapped ids are used in place, so only little-endian hosts are supported.
+static_assert (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+    "Binary traces are little-endian");
+static_assert (sizeof (testPageId_t) == sizeof (std::uint32_t),
+    "Binary traces store uint32 ids");
+
+/* Binary trace format (all values are little-endian):
+
+       <HEADER> <PACKED UINT32 IDS>
+
+   Header layout is BinTraceHeader.
+*/
+struct BinTraceHeader
+{
+    static constexpr char MAGIC[4] = {'C', 'T', 'R', 'C'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic_[4] = {};
+    std::uint32_t version_ = 0;
+    std::uint64_t cacheSize_ = 0;
+    std::uint64_t idsNum_ = 0;
+};
+static_assert (sizeof (BinTraceHeader) == 24, "BinTraceHeader should be packed");
+
+// Converts trace from text format:
+//     <CACHE CAPACITY> <SEQUENCE SIZE> <SEQUENCE>
+// to binary format. Returns false on failure.
+bool convertTrace( const char * textFilename, const char * binFilename );
+
+// Writes ids sequence to binary trace. Returns false on failure.
+bool writeTrace( const char * binFilename, size_t cacheSize, const testPageId_t * ids, size_t idsNum );
+
+// Binary trace mapped to memory. Ids are not copied or parsed.
+class MappedTrace
+{
+    MappedFile file_;
+
+    const BinTraceHeader * header_ = nullptr;
+    const testPageId_t * ids_ = nullptr;
+
+public:
+
+    // Trace is invalid if file can't be mapped or has wrong format.
+    MappedTrace( const char * filename );
+
+   ~MappedTrace() = default;
+    MappedTrace( const MappedTrace& ) = delete;
+    MappedTrace( MappedTrace&& ) = delete;
+    MappedTrace& operator=( const MappedTrace& ) = delete;
+    MappedTrace& operator=( MappedTrace&& ) = delete;
+
+    bool isValid() const;
+
+    size_t getCacheSize() const;
+    size_t size() const;
+    const testPageId_t * ids() const;
+};
+
+} // namespace caches
+
+#endif // #ifndef CACHE_TRACE_HH_INCL
@@ -0,0 +1,298 @@
+#ifndef CACHE_TTL_IMPL_HH_INCL
+#define CACHE_TTL_IMPL_HH_INCL
+
+namespace caches
+{
+
+inline TimingWheel::TimingWheel( size_t capacity, tick_t now ) :
+    nodes_ (capacity),
+    now_ (now)
+{
+    assert (capacity < NIL_SLOT);
+
+    for (auto& level : heads_)
+        level.fill (NIL_SLOT);
+}
+
+inline tick_t TimingWheel::now() const
+{
+    return now_;
+}
+
+inline size_t TimingWheel::size() const
+{
+    return size_;
+}
+
+inline bool TimingWheel::isScheduled( slot_t slot ) const
+{
+    return nodes_[slot].level_ != NO_LEVEL_;
+}
+
+inline tick_t TimingWheel::getDeadline( slot_t slot ) const
+{
+    return nodes_[slot].deadline_;
+}
+
+inline void TimingWheel::place( slot_t slot )
+{
+    Node& node = nodes_[slot];
+    tick_t due = std::max (node.deadline_, now_ + 1);
+
+    // Highest bits group where due differs from now (due != now).
+    size_t level = (63 - __builtin_clzll (due ^ now_)) / SLOT_BITS_;
+    size_t bucket = 0;
+    if (level < LEVELS_NUM_)
+        bucket = (due >> (level * SLOT_BITS_)) & SLOT_MASK_;
+    else
+    {
+        // Current bucket of the last level is reached again after the whole round.
+        level = LEVELS_NUM_ - 1;
+        bucket = (now_ >> (level * SLOT_BITS_)) & SLOT_MASK_;
+    }
+
+    slot_t& head = heads_[level][bucket];
+
+    node.level_ = level;
+    node.bucket_ = bucket;
+    node.prev_ = NIL_SLOT;
+    node.next_ = head;
+
+    if (head != NIL_SLOT)
+        nodes_[head].prev_ = slot;
+    head = slot;
+
+    occupied_[level] |= std::uint64_t {1} << bucket;
+}
+
+inline void TimingWheel::unlink( slot_t slot )
+{
+    Node& node = nodes_[slot];
+    slot_t& head = heads_[node.level_][node.bucket_];
+
+    if (node.prev_ != NIL_SLOT)
+        nodes_[node.prev_].next_ = node.next_;
+    else
+        head = node.next_;
+
+    if (node.next_ != NIL_SLOT)
+        nodes_[node.next_].prev_ = node.prev_;
+
+    if (head == NIL_SLOT)
+        occupied_[node.level_] &= ~(std::uint64_t {1} << node.bucket_);
+
+    node.level_ = NO_LEVEL_;
+}
+
+inline void TimingWheel::schedule( slot_t slot, tick_t deadline )
+{
+    assert (!isScheduled (slot));
+
+    nodes_[slot].deadline_ = deadline;
+    place (slot);
+    ++size_;
+}
+
+inline void TimingWheel::cancel( slot_t slot )
+{
+    if (!isScheduled (slot))
+        return;
+
+    unlink (slot);
+    --size_;
+}
+
+inline tick_t TimingWheel::getNextTick() const
+{
+    tick_t next = ~tick_t {0};
+
+    for (size_t level = 0; level < LEVELS_NUM_; ++level)
+    {
+        if (occupied_[level] == 0)
+            continue;
+
+        size_t shift = level * SLOT_BITS_;
+        size_t current = (now_ >> shift) & SLOT_MASK_;
+        tick_t roundBegin = now_ >> (shift + SLOT_BITS_) << (shift + SLOT_BITS_);
+
+        // Buckets after current one are reached in this round, others in the next one.
+        std::uint64_t ahead = current == SLOT_MASK_ ? 0 : occupied_[level] & (~std::uint64_t {0} << (current + 1));
+        tick_t reached = ahead != 0 ?
+            roundBegin + (tick_t (__builtin_ctzll (ahead)) << shift) :
+            roundBegin + (tick_t {1} << (shift + SLOT_BITS_)) + (tick_t (__builtin_ctzll (occupied_[level])) << shift);
+
+        next = std::min (next, reached);
+    }
+
+    return next;
+}
+
+template <typename Expire>
+void TimingWheel::cascade( size_t level, size_t bucket, Expire& expire )
+{
+    // Bucket is detached first: the last level timers can be placed back to it.
+    slot_t slot = heads_[level][bucket];
+    heads_[level][bucket] = NIL_SLOT;
+    occupied_[level] &= ~(std::uint64_t {1} << bucket);
+
+    while (slot != NIL_SLOT)
+    {
+        Node& node = nodes_[slot];
+        slot_t next = node.next_;
+
+        if (node.deadline_ <= now_)
+        {
+            node.level_ = NO_LEVEL_;
+            --size_;
+            expire (slot);
+        }
+        else
+            place (slot);
+
+        slot = next;
+    }
+}
+
+template <typename Expire>
+void TimingWheel::advance( tick_t tick, Expire expire )
+{
+    while (size_ != 0)
+    {
+        tick_t next = getNextTick ();
+        if (next > tick)
+            break;
+        now_ = next;
+
+        // Upper levels first: their timers can go to lower levels current buckets.
+        for (size_t level = LEVELS_NUM_; level-- > 0;)
+        {
+            size_t shift = level * SLOT_BITS_;
+            if ((now_ & ((tick_t {1} << shift) - 1)) == 0)
+                cascade (level, (now_ >> shift) & SLOT_MASK_, expire);
+        }
+    }
+
+    now_ = std::max (now_, tick);
+}
+
+inline CoarseClock::CoarseClock( std::chrono::nanoseconds tick ) :
+    tick_ (std::chrono::duration_cast<Clock::duration> (tick)),
+    start_ (Clock::now ()),
+    thread_ ([this] { update (); })
+{
+    assert (tick_.count () > 0);
+}
+
+inline CoarseClock::~CoarseClock()
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        stop_ = true;
+    }
+    stopCond_.notify_one ();
+    thread_.join ();
+}
+
+inline void CoarseClock::update()
+{
+    std::unique_lock<std::mutex> lock {mutex_};
+
+    while (!stopCond_.wait_for (lock, tick_, [this] { return stop_; }))
+        ticks_.store ((Clock::now () - start_) / tick_, std::memory_order_relaxed);
+}
+
+inline tick_t CoarseClock::now() const
+{
+    return ticks_.load (std::memory_order_relaxed);
+}
+
+template <typename T, typename T_id>
+CacheTtlLRU<T, T_id>::CacheTtlLRU( size_t capacity, tick_t ttl, const CoarseClock * clock ) :
+    capacity_ (std::max<size_t> (capacity, MIN_CAPACITY_)),
+    ttl_ (ttl),
+    clock_ (clock),
+    storage_ (capacity_),
+    wheel_ (capacity_, clock == nullptr ? 0 : clock->now ())
+{}
+
+template <typename T, typename T_id>
+template <typename... Args>
+const T& CacheTtlLRU<T, T_id>::place( T_id id, tick_t ttl, Args&&... args )
+{
+    if (storage_.isFull ())
+    {
+        slot_t victim = storage_.back (0);
+        wheel_.cancel (victim);
+        storage_.erase (0, victim);
+    }
+
+    slot_t slot = storage_.emplaceFront (0, id, std::forward<Args> (args)...);
+    wheel_.schedule (slot, wheel_.now () + ttl);
+
+    return storage_.elem (slot);
+}
+
+template <typename T, typename T_id>
+const T& CacheTtlLRU<T, T_id>::getElem( T_id id )
+{
+    if (clock_ != nullptr)
+        advance (clock_->now ());
+
+    // Stored elements are not expired, so hit checks no time.
+    slot_t slot = storage_.find (0, id);
+
+    if (slot == NIL_SLOT) // Not cached or expired element.
+        return place (id, ttl_, id);
+
+    storage_.move2Front (0, slot);
+
+    return storage_.elem (slot);
+}
+
+template <typename T, typename T_id>
+void CacheTtlLRU<T, T_id>::addElem( EnId<T, T_id> pair, tick_t ttl )
+{
+    if (clock_ != nullptr)
+        advance (clock_->now ());
+
+    slot_t oldSlot = storage_.find (0, pair.second);
+
+    if (oldSlot != NIL_SLOT) // Remove old value.
+    {
+        wheel_.cancel (oldSlot);
+        storage_.erase (0, oldSlot);
+    }
+
+    place (pair.second, ttl, std::move (pair.first));
+}
+
+template <typename T, typename T_id>
+bool CacheTtlLRU<T, T_id>::isCached( T_id id ) const
+{
+    return storage_.find (0, id) != NIL_SLOT;
+}
+
+template <typename T, typename T_id>
+void CacheTtlLRU<T, T_id>::advance( tick_t tick )
+{
+    if (tick <= wheel_.now ())
+        return;
+
+    wheel_.advance (tick, [this]( slot_t slot ) { storage_.erase (0, slot); });
+}
+
+template <typename T, typename T_id>
+tick_t CacheTtlLRU<T, T_id>::now() const
+{
+    return wheel_.now ();
+}
+
+template <typename T, typename T_id>
+size_t CacheTtlLRU<T, T_id>::size() const
+{
+    return storage_.size (0);
+}
+
+} // namespace caches
+
+#endif // #ifndef CACHE_TTL_IMPL_HH_INCL
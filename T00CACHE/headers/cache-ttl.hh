@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef CACHE_TTL_HH_INCL
+#define CACHE_TTL_HH_INCL
+
+#include "cache.hh"
+
+namespace caches {
+
+// Time in ticks of TimingWheel & CoarseClock.
+using tick_t = std::uint64_t;
+
+// Hierarchical timing wheel for timers attached to storage slots.
+// LEVELS_NUM_ wheels of SLOTS_NUM_ buckets, bucket of level l covers
+// SLOTS_NUM_^l ticks. Timer is placed to the level of the highest bits
+// where its deadline differs from current tick and is moved to lower
+// levels when time reaches its bucket. Schedule & cancel are O(1),
+// expired timers are taken from buckets without scanning others.
+//
+// Timer nodes are preallocated for all slots in ctor.
+class TimingWheel
+{
+    static constexpr size_t SLOT_BITS_ = 6;
+    static constexpr size_t SLOTS_NUM_ = size_t {1} << SLOT_BITS_;
+    static constexpr tick_t SLOT_MASK_ = SLOTS_NUM_ - 1;
+    // 2^24 ticks horizon, farther timers wait in the last level.
+    static constexpr size_t LEVELS_NUM_ = 4;
+    // Level of not scheduled timer.
+    static constexpr std::uint8_t NO_LEVEL_ = LEVELS_NUM_;
+
+    struct Node
+    {
+        tick_t deadline_ = 0;
+        slot_t prev_ = NIL_SLOT;
+        slot_t next_ = NIL_SLOT;
+        std::uint8_t level_ = NO_LEVEL_;
+        std::uint8_t bucket_ = 0;
+    };
+
+    std::vector<Node> nodes_;
+    std::array<std::array<slot_t, SLOTS_NUM_>, LEVELS_NUM_> heads_;
+    // Bit i is set if bucket i of level is not empty.
+    std::array<std::uint64_t, LEVELS_NUM_> occupied_ {};
+
+    tick_t now_ = 0;
+    size_t size_ = 0;
+
+    // Links timer to bucket by its deadline.
+    void place( slot_t );
+    void unlink( slot_t );
+    // Nearest tick when not empty bucket is reached.
+    tick_t getNextTick() const;
+    // Expires or places to lower levels all timers of bucket.
+    template <typename Expire>
+    void cascade( size_t level, size_t bucket, Expire& expire );
+
+public:
+
+    // capacity = number of slots timers can be attached to.
+    TimingWheel( size_t capacity, tick_t now = 0 );
+
+    tick_t now() const;
+    // Number of scheduled timers.
+    size_t size() const;
+
+    bool isScheduled( slot_t ) const;
+    tick_t getDeadline( slot_t ) const;
+
+    // Slot timer should not be scheduled. Timer with deadline <= now
+    // is expired on the next tick.
+    void schedule( slot_t, tick_t deadline );
+    // Does nothing for not scheduled timer.
+    void cancel( slot_t );
+
+    // Moves time forward to tick, calls expire (slot) for all timers with
+    // deadline <= tick. Timer is not scheduled any more when expire is called.
+    // Time without timers to expire is skipped by whole buckets.
+    template <typename Expire>
+    void advance( tick_t, Expire expire );
+};
+
+// Ticks counter updated by background thread: time is read
+// with one relaxed load, without clock call.
+class CoarseClock
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::duration tick_;
+    const Clock::time_point start_;
+    std::atomic<tick_t> ticks_ {0};
+
+    std::mutex mutex_;
+    std::condition_variable stopCond_;
+    bool stop_ = false;
+
+    std::thread thread_;
+
+    void update();
+
+public:
+
+    CoarseClock( std::chrono::nanoseconds tick );
+
+   ~CoarseClock();
+    CoarseClock( const CoarseClock& ) = delete;
+    CoarseClock( CoarseClock&& ) = delete;
+    CoarseClock& operator=( const CoarseClock& ) = delete;
+    CoarseClock& operator=( CoarseClock&& ) = delete;
+
+    // Ticks since clock creation.
+    tick_t now() const;
+};
+
+// LRU cache with time to live for elements.
+// Expired elements are destroyed by TimingWheel when cache time is
+// advanced, so lookups never see them and hits check no timestamps.
+// Time is advanced with advance (tick) or, if clock is given, taken
+// from it on each getElem (one relaxed load while tick is the same).
+template <typename T, typename T_id>
+class CacheTtlLRU
+{
+    // Max cached elems num.
+    const size_t capacity_;
+    // Min maxSize_ value.
+    static constexpr size_t MIN_CAPACITY_ = 1;
+    // Time to live of elements loaded by getElem, in ticks.
+    const tick_t ttl_;
+    const CoarseClock * clock_;
+
+    // Elements are ordered from the most to the least recently used.
+    FlatStorage<T, T_id> storage_;
+    // Timers of storage slots.
+    TimingWheel wheel_;
+
+    // Constructs element from args. Id should not be cached.
+    template <typename... Args>
+    const T& place( T_id, tick_t ttl, Args&&... );
+
+public:
+
+    // clock should live longer than cache.
+    CacheTtlLRU( size_t capacity, tick_t ttl, const CoarseClock * clock = nullptr );
+
+   ~CacheTtlLRU() = default;
+    CacheTtlLRU( const CacheTtlLRU& ) = default;
+    CacheTtlLRU( CacheTtlLRU&& ) = default;
+    CacheTtlLRU& operator=( const CacheTtlLRU& ) = default;
+    CacheTtlLRU& operator=( CacheTtlLRU&& ) = default;
+
+    // Searches element by it's id. Caches frequiently accessed elements.
+    // Hit does not prolong element life.
+    // Reference is valid until next cache modification.
+    const T& getElem( T_id );
+    // Forces element caching with its own time to live.
+    // Element is moved to cache.
+    void addElem( EnId<T, T_id>, tick_t ttl );
+    // To check if element cached (& not expired).
+    bool isCached( T_id ) const;
+
+    // Moves cache time forward & destroys expired elements.
+    void advance( tick_t );
+    tick_t now() const;
+    size_t size() const;
+};
+
+} // namespace caches
+
+#include "cache-ttl-impl.hh"
+
+#endif // #ifndef CACHE_TTL_HH_INCL
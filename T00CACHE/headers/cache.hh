@@ -1,6 +1,16 @@
 
-#include <list>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <set>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -12,109 +22,299 @@
 
 /*  TODO:
 
-    1) Isolate pairs (list, unorderedMap) into separate class with all needed functionality;
-    2) Implement ideal caching to cmp hit rates;
-    3) Add readme.
+    1) Add readme.
 
 */
 
+#include "cache-storage.hh"
+#include "cache-loader.hh"
+#include "cache-metrics.hh"
+#include "cache-policy.hh"
+
 namespace caches {
 
-// To store element + its id.
+// LRU cache. All slots are allocated in ctor & elements are kept
+// in one array, so steady-state work does not allocate.
 template <typename T, typename T_id>
-using EnId = typename std::pair<T, T_id>;
+using CacheLRU = PolicyCache<T, T_id, LruEviction, FlatIndex<T_id>, FlatValues<T>>;
 
-// Iterator type for list of EnId pairs.
+// 2Q cache (see TwoQEviction), supports admission filter, evict handler
+// & snapshots. Elements promoted from ALout to AM are not moved.
 template <typename T, typename T_id>
-using EListIt = typename std::list<EnId<T, T_id>>::iterator;
+using Cache2Q = PolicyCache<T, T_id, TwoQEviction, FlatIndex<T_id>, FlatValues<T>>;
 
+// CLOCK cache (see ClockEviction).
 template <typename T, typename T_id>
-class CacheLRU
-{
-    std::list<EnId<T, T_id>> elemsList_;
-    std::unordered_map<T_id, EListIt<T, T_id>> hashTable_;
-
-    // Max cached elems num.
-    const size_t capacity_;
-    // Min maxSize_ value.
-    static constexpr size_t MIN_CAPACITY_ = 1;
-    // Currently cached elements number.
-    size_t cachedElemsNum_ = 0;
-
-public:
-
-    CacheLRU( size_t capacity );
-
-   ~CacheLRU() = default;
-    CacheLRU( const CacheLRU& ) = default;
-    CacheLRU( CacheLRU&& ) = default;
-    CacheLRU& operator=( const CacheLRU& ) = default;
-    CacheLRU& operator=( CacheLRU&& ) = default;
-
-    // Searches element by it's id. Caches frequiently accessed elements.
-    T getElem( T_id );
-    // Forces element caching.
-    void addElem( EnId<T, T_id> );
-    // To check if element cached.
-    bool isCached( T_id ) const;
-
-};
+using CacheClock = PolicyCache<T, T_id, ClockEviction, FlatIndex<T_id>, FlatValues<T>>;
 
+// 2Q cache with self-tuning AM / ALin split (in the style of ARC).
+// ALout works as ghost list for ALin: ALout hits increase ALin capacity.
+// Ids of elements evicted from AM are kept in AM ghost list:
+// misses on these ids increase AM capacity.
 template <typename T, typename T_id>
-class Cache2Q
+class CacheAdaptive2Q
 {
-    // For once accesed elements. Managed as FIFO.
-    std::list<EnId<T, T_id>> alinList_; 
-    std::unordered_map<T_id, EListIt<T, T_id>> alinHashTable_;
+    // Storage segments - the same as in Cache2Q.
+    enum Segment : size_t
+    {
+        AM,
+        ALIN,
+        ALOUT,
+
+        SEGMENTS_NUM
+    };
 
-    // For way back accessed elements. Managed as FIFO.
-    std::list<EnId<T, T_id>> aloutList_;
-    std::unordered_map<T_id, EListIt<T, T_id>> aloutHashTable_;
+    // Ghost list stores only ids.
+    struct NoElem {};
 
-    // Good proportions for lists capacities.
-    static constexpr double AM_QUOTA_ = 0.25;
-    static constexpr double ALIN_QUOTA_ = 0.25;
-    static_assert (AM_QUOTA_ + ALIN_QUOTA_ <= 1,
-        "AM_QUOTA_ + ALIN_QUOTA_ cant be above 1.0");
+    // Initial proportions for lists capacities.
+    static constexpr double INIT_AM_QUOTA_ = 0.25;
+    static constexpr double INIT_ALIN_QUOTA_ = 0.25;
 
     // Minimum capacities for lists.
     static constexpr size_t MIN_AM_CAPACITY_ = 1;
     static constexpr size_t MIN_ALIN_CAPACITY_ = 1;
     static constexpr size_t MIN_ALOUT_CAPACITY_ = 2;
 
-    // Public const for users to know.
 public: static constexpr size_t MIN_2Q_CAPACITY_ =
     MIN_AM_CAPACITY_ + MIN_ALIN_CAPACITY_ + MIN_ALOUT_CAPACITY_;
 private:
 
-    // Lists capacities.
-    const size_t amCapacity_;
-    const size_t alinCapacity_;
+    // amCapacity_ + alinCapacity_ is constant, split is tuned at runtime.
+    size_t amCapacity_;
+    size_t alinCapacity_;
     const size_t aloutCapacity_;
 
-    // LRU cache to store hottest elements.
-    CacheLRU<T, T_id> am_;
+    // All segments share one slots pool allocated in ctor.
+    FlatStorage<T, T_id, SEGMENTS_NUM> storage_;
+    // Ids of elements evicted from AM.
+    FlatStorage<NoElem, T_id> amGhosts_;
+
+    size_t aloutHitsNum_ = 0;
+    size_t amGhostHitsNum_ = 0;
+
+    CacheMetrics metrics_;
 
-    // Numbers of currently cached elements.
-    size_t alinCachedElemsNum_ = 0;
-    size_t aloutCachedElemsNum_ = 0;
+    // Moves AM tail to AM ghost list.
+    void evictAm();
+    // Frees slot in storage for new element.
+    void freeSlot();
 
-    // Loads uncached element to ALin.
-    T load2Cache( T_id );
+    // Split tuning on ghost lists hits.
+    void growAlin();
+    void growAm();
 
 public:
+    // Current split & tuning statistics.
+    struct Stats
+    {
+        size_t amCapacity_ = 0;
+        size_t alinCapacity_ = 0;
+        size_t aloutCapacity_ = 0;
+
+        size_t amSize_ = 0;
+        size_t alinSize_ = 0;
+        size_t aloutSize_ = 0;
+        size_t amGhostsSize_ = 0;
+
+        size_t aloutHitsNum_ = 0;
+        size_t amGhostHitsNum_ = 0;
+    };
+
     // capacity = number of elements that can be cached in memory.
     // But there is minimum capacity value.
-    Cache2Q( size_t capacity );
+    CacheAdaptive2Q( size_t capacity );
 
-   ~Cache2Q() = default;
-    Cache2Q( const Cache2Q& ) = default;
-    Cache2Q( Cache2Q&& ) = default;
-    Cache2Q& operator=( const Cache2Q& ) = default;
-    Cache2Q& operator=( Cache2Q&& ) = default;
+   ~CacheAdaptive2Q() = default;
+    CacheAdaptive2Q( const CacheAdaptive2Q& ) = default;
+    CacheAdaptive2Q( CacheAdaptive2Q&& ) = default;
+    CacheAdaptive2Q& operator=( const CacheAdaptive2Q& ) = default;
+    CacheAdaptive2Q& operator=( CacheAdaptive2Q&& ) = default;
 
     // Searches element by it's id. Caches frequiently accessed elements.
+    // Reference is valid until next cache modification.
+    const T& getElem( T_id );
+
+    Stats getStats() const;
+    // Can be called from any thread, even when cache is used in other one.
+    CacheMetrics::Snapshot getMetrics() const;
+};
+
+// Thread safe 2Q cache. Ids are distributed between independent
+// Cache2Q shards by hash, each shard is protected with its own mutex.
+template <typename T, typename T_id>
+class ShardedCache2Q
+{
+    // Aligned to avoid false sharing of neighbour shards mutexes.
+    struct alignas(64) Shard
+    {
+        std::mutex mutex_;
+        Cache2Q<T, T_id> cache_;
+
+        Shard( size_t capacity );
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+public:
+    // Capacity is divided between shards, so overall capacity is kept.
+    // Shards number is decreased if shards are too small.
+    // shardsNum = 0 means shard per hardware thread.
+    ShardedCache2Q( size_t capacity, size_t shardsNum = 0 );
+
+   ~ShardedCache2Q() = default;
+    ShardedCache2Q( const ShardedCache2Q& ) = delete;
+    ShardedCache2Q( ShardedCache2Q&& ) = default;
+    ShardedCache2Q& operator=( const ShardedCache2Q& ) = delete;
+    ShardedCache2Q& operator=( ShardedCache2Q&& ) = default;
+
+    size_t getShardsNum() const;
+    // Index of shard which caches given id.
+    size_t getShardId( T_id ) const;
+
+    // Searches element by it's id. Can be called from several threads.
+    // Element is copied under shard lock, so T should be copyable.
     T getElem( T_id );
+
+    // Thread safe versions of Cache2Q findElem & addLoaded.
+    std::optional<T> findElem( T_id );
+    void addLoaded( T_id, T );
+
+    // Same as getElem, but missed elements are loaded with loader and
+    // caller is not blocked. Loads of the same id are coalesced by loader.
+    // Cache should not be destroyed before loader.
+    std::shared_future<T> getElemAsync( T_id, AsyncLoader<T, T_id>& loader );
+
+    // Sum of shards metrics. Shards are not locked.
+    CacheMetrics::Snapshot getMetrics() const;
+};
+
+// CLOCK-Pro (Jiang, Chen & Zhang, 2005): CLOCK with hot & cold resident
+// elements, like in 2Q. Ids of evicted cold elements are kept for a test
+// period: if such id is requested again, its element is loaded as hot one.
+// Hits only set reference bit, like in CacheClock.
+template <typename T, typename T_id>
+class CacheClockPro
+{
+    enum class Status
+    {
+        HOT,
+        COLD,
+        // Evicted cold element in test period: only id is stored.
+        TEST
+    };
+
+    // Clock ring node.
+    struct Entry
+    {
+        std::optional<T> elem_;
+        T_id id_ {};
+        Status status_ = Status::COLD;
+        bool ref_ = false;
+
+        slot_t prev_ = NIL_SLOT;
+        slot_t next_ = NIL_SLOT;
+    };
+
+    // Max cached elems num.
+    const size_t capacity_;
+    // Min capacity_ value.
+    static constexpr size_t MIN_CAPACITY_ = 1;
+
+    // Max part of capacity for cold resident elements. Hot elements are
+    // searched by hot hand, so too rare hot elements make it go round & round.
+    static constexpr double MAX_COLD_QUOTA_ = 0.75;
+    const size_t maxColdCapacity_;
+    // Target number of cold resident elements. Tuned at runtime.
+    size_t coldCapacity_;
+
+    size_t hotNum_ = 0;
+    size_t coldNum_ = 0;
+    size_t testNum_ = 0;
+
+    // Resident elements & test ids: up to 2 * capacity_ entries.
+    std::vector<Entry> entries_;
+    FlatIndex<T_id> index_;
+    // Free entries are linked with next_ only.
+    slot_t freeHead_ = NIL_SLOT;
+
+    // NIL_SLOT for empty ring.
+    slot_t handHot_ = NIL_SLOT;
+    slot_t handCold_ = NIL_SLOT;
+    slot_t handTest_ = NIL_SLOT;
+
+    CacheMetrics metrics_;
+
+    // New entry is linked just behind hot hand.
+    slot_t addEntry( T_id, Status );
+    void delEntry( slot_t );
+
+    // Evicts cold elements until there is space for new element.
+    void evict();
+
+    void runHandCold();
+    void runHandHot();
+    void runHandTest();
+
+public:
+
+    CacheClockPro( size_t capacity );
+
+   ~CacheClockPro() = default;
+    CacheClockPro( const CacheClockPro& ) = default;
+    CacheClockPro( CacheClockPro&& ) = default;
+    CacheClockPro& operator=( const CacheClockPro& ) = default;
+    CacheClockPro& operator=( CacheClockPro&& ) = default;
+
+    // Searches element by it's id. Caches frequiently accessed elements.
+    // Reference is valid until next cache modification.
+    const T& getElem( T_id );
+    // To check if element cached.
+    bool isCached( T_id ) const;
+
+    // Can be called from any thread, even when cache is used in other one.
+    CacheMetrics::Snapshot getMetrics() const;
+};
+
+// Ideal (Belady's OPT) caching - evicts element that will be
+// requested latest. Used to cmp hit rates with theoretical optimum,
+// so the whole requests sequence should be known in advance.
+template <typename T, typename T_id>
+class CacheBelady
+{
+    // Max cached elems num.
+    const size_t capacity_;
+    // Min capacity_ value.
+    static constexpr size_t MIN_CAPACITY_ = 1;
+
+    // nextUse_[i] = position of next request with the same id as i-th request.
+    // Requests sequence size for last requests.
+    std::vector<size_t> nextUse_;
+    // Position of the current request.
+    size_t curPos_ = 0;
+
+    // Cached elements with their next use positions.
+    std::unordered_map<T_id, std::pair<T, size_t>> hashTable_;
+    // Cached elements ordered by next use. Last one is the next victim.
+    std::set<std::pair<size_t, T_id>> nextUseOrder_;
+    // Last loaded but not cached element.
+    std::optional<T> bypassed_;
+
+public:
+
+    // Next use positions are precomputed in ctor in O(seqSize).
+    CacheBelady( size_t capacity, const T_id * seq, size_t seqSize );
+
+   ~CacheBelady() = default;
+    CacheBelady( const CacheBelady& ) = default;
+    CacheBelady( CacheBelady&& ) = default;
+    CacheBelady& operator=( const CacheBelady& ) = default;
+    CacheBelady& operator=( CacheBelady&& ) = default;
+
+    // Searches element by it's id in O(log(capacity)).
+    // Ids should be requested in the same order as in ctor sequence.
+    // Reference is valid until next cache modification.
+    const T& getElem( T_id );
 };
 
 } // namespace caches
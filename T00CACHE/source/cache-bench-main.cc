@@ -0,0 +1,45 @@
+#include <cstring>
+
+#include "cache-bench.hh"
+
+int main( int argc, char ** argv )
+{
+    static const char USAGE[] =
+        "Usage: cache-bench <BENCHMARK> [ARGS]\n"
+        "Benchmarks:\n"
+        "    policies [TRACE FILES] - all policies on synthetic & recorded traces\n"
+        "    sharded - ShardedCache2Q throughput scaling\n"
+        "    reads   - ConcurrentCacheLRU hits throughput scaling\n"
+        "    loader  - AsyncLoader misses coalescing\n"
+        "    batch   - getElems batches vs getElem loop\n"
+        "    ttl     - CacheTtlLRU vs load time checks on hits\n"
+        "    tiered  - Cache2Q with & without disk tier\n";
+
+    if (argc < 2)
+    {
+        std::cout << USAGE;
+        return 1;
+    }
+
+    if (!std::strcmp (argv[1], "policies"))
+        caches::benchPolicies (argc - 2, argv + 2);
+    else if (!std::strcmp (argv[1], "sharded"))
+        caches::benchShardedThroughput ();
+    else if (!std::strcmp (argv[1], "reads"))
+        caches::benchReadMostly ();
+    else if (!std::strcmp (argv[1], "loader"))
+        caches::benchAsyncLoader ();
+    else if (!std::strcmp (argv[1], "batch"))
+        caches::benchBatchLookup ();
+    else if (!std::strcmp (argv[1], "ttl"))
+        caches::benchTtlLookup ();
+    else if (!std::strcmp (argv[1], "tiered"))
+        caches::benchTieredCache ();
+    else
+    {
+        std::cout << USAGE;
+        return 1;
+    }
+
+    return 0;
+}
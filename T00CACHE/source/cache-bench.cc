@@ -0,0 +1,684 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <thread>
+
+#include "cache-bench.hh"
+#include "cache-trace.hh"
+
+namespace caches
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// TestPage counts misses with not thread safe static counter,
+// so multithreaded benchmarks use this page type.
+struct BenchPage
+{
+    char placeHolder_[64] = "";
+
+    BenchPage( testPageId_t ) {}
+};
+
+// Page from remote storage with simulated load latency.
+struct SlowPage
+{
+    static constexpr std::chrono::microseconds LOAD_LATENCY {500};
+    static inline std::atomic<size_t> loadsNum_ {0};
+
+    char placeHolder_[64] = "";
+
+    SlowPage( testPageId_t )
+    {
+        ++loadsNum_;
+        std::this_thread::sleep_for (LOAD_LATENCY);
+    }
+};
+
+// Page with load time, for ttl checked outside of cache.
+struct StampedPage
+{
+    BenchPage page_;
+    Clock::time_point loadTime_;
+
+    StampedPage( testPageId_t id ) : page_ {id}, loadTime_ (Clock::now ()) {}
+};
+
+// Thread numbers to bench: 1, 2, 4 ... and hardware_concurrency.
+std::vector<size_t> getThreadsNums()
+{
+    size_t maxThreadsNum = std::max<size_t> (std::thread::hardware_concurrency (), 1);
+    std::vector<size_t> threadsNums {};
+
+    for (size_t threadsNum = 1; threadsNum < maxThreadsNum; threadsNum *= 2)
+        threadsNums.push_back (threadsNum);
+    threadsNums.push_back (maxThreadsNum);
+
+    return threadsNums;
+}
+
+// Each thread passes its own trace to lookup (id) or lookup (threadId, id).
+// Returns number of lookups per second for all threads.
+template <typename Lookup>
+double runThreads( const std::vector<std::vector<testPageId_t>>& traces, size_t threadsNum, Lookup lookup )
+{
+    std::atomic<size_t> readyNum {0};
+    std::atomic<bool> start {false};
+    std::vector<std::thread> threads {};
+
+    for (size_t threadId = 0; threadId < threadsNum; ++threadId)
+        threads.emplace_back ([&, threadId]
+        {
+            ++readyNum;
+            while (!start)
+                std::this_thread::yield ();
+
+            for (testPageId_t id : traces[threadId])
+                if constexpr (std::is_invocable_v<Lookup, size_t, testPageId_t>)
+                    lookup (threadId, id);
+                else
+                    lookup (id);
+        });
+
+    while (readyNum != threadsNum)
+        std::this_thread::yield ();
+
+    Clock::time_point begin = Clock::now ();
+    start = true;
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    std::chrono::duration<double> time = Clock::now () - begin;
+    size_t lookupsNum = 0;
+    for (size_t threadId = 0; threadId < threadsNum; ++threadId)
+        lookupsNum += traces[threadId].size ();
+
+    return lookupsNum / time.count ();
+}
+
+// Each thread passes its own trace to lookup.
+// Prints requests latencies percentiles & backend loads number.
+template <typename Lookup>
+void runLatencyTest( const char * name, const std::vector<std::vector<testPageId_t>>& traces, Lookup lookup )
+{
+    std::vector<std::vector<double>> latencies (traces.size ());
+    std::vector<std::thread> threads {};
+    SlowPage::loadsNum_ = 0;
+
+    for (size_t threadId = 0; threadId < traces.size (); ++threadId)
+        threads.emplace_back ([&, threadId]
+        {
+            for (testPageId_t id : traces[threadId])
+            {
+                Clock::time_point begin = Clock::now ();
+                lookup (id);
+                std::chrono::duration<double, std::micro> time = Clock::now () - begin;
+
+                latencies[threadId].push_back (time.count ());
+            }
+        });
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    std::vector<double> all {};
+    for (const std::vector<double>& threadLatencies : latencies)
+        all.insert (all.end (), threadLatencies.begin (), threadLatencies.end ());
+    std::sort (all.begin (), all.end ());
+
+    auto percentile = [&all]( double part ) { return all[static_cast<size_t> (part * (all.size () - 1))]; };
+
+    std::cout << std::setw (18) << name << std::setw (14) << SlowPage::loadsNum_
+              << std::fixed << std::setprecision (1)
+              << std::setw (12) << percentile (0.5) << std::setw (12) << percentile (0.99)
+              << std::setw (12) << percentile (0.999) << std::setw (12) << all.back () << std::endl;
+}
+
+// Log-linear latency histogram: values are grouped by powers of two,
+// each power of two is splitted into SUB_BUCKETS_NUM equal buckets.
+// So percentiles relative error is below 1 / SUB_BUCKETS_NUM.
+class LatencyHistogram
+{
+    static constexpr size_t SUB_BITS = 4;
+    static constexpr size_t SUB_BUCKETS_NUM = 1 << SUB_BITS;
+    static constexpr size_t BUCKETS_NUM = (64 - SUB_BITS + 1) * SUB_BUCKETS_NUM;
+
+    std::array<size_t, BUCKETS_NUM> counts_ {};
+    size_t totalCount_ = 0;
+
+    static size_t getBucketId( std::uint64_t val )
+    {
+        if (val < SUB_BUCKETS_NUM)
+            return val;
+
+        size_t exp = 63 - __builtin_clzll (val);
+        size_t sub = (val >> (exp - SUB_BITS)) & (SUB_BUCKETS_NUM - 1);
+
+        return (exp - SUB_BITS + 1) * SUB_BUCKETS_NUM + sub;
+    }
+
+    // Min value in bucket.
+    static std::uint64_t getBucketVal( size_t bucketId )
+    {
+        if (bucketId < SUB_BUCKETS_NUM)
+            return bucketId;
+
+        size_t exp = bucketId / SUB_BUCKETS_NUM + SUB_BITS - 1;
+        std::uint64_t sub = bucketId % SUB_BUCKETS_NUM;
+
+        return (SUB_BUCKETS_NUM + sub) << (exp - SUB_BITS);
+    }
+
+public:
+
+    void add( std::uint64_t val )
+    {
+        ++counts_[getBucketId (val)];
+        ++totalCount_;
+    }
+
+    // part is in [0, 1].
+    std::uint64_t getPercentile( double part ) const
+    {
+        size_t toSkip = static_cast<size_t> (part * totalCount_);
+        size_t counted = 0;
+
+        for (size_t bucketId = 0; bucketId < BUCKETS_NUM; ++bucketId)
+        {
+            counted += counts_[bucketId];
+            if (counted > toSkip)
+                return getBucketVal (bucketId);
+        }
+
+        return totalCount_ == 0 ? 0 : getBucketVal (BUCKETS_NUM - 1);
+    }
+};
+
+// Peak resident memory is reset, so next getPeakRssKb call
+// returns peak since this call. Works on linux only.
+void resetPeakRss()
+{
+    std::ofstream clearRefs {"/proc/self/clear_refs"};
+    clearRefs << "5";
+}
+
+size_t getPeakRssKb()
+{
+    std::ifstream status {"/proc/self/status"};
+    std::string word {};
+
+    while (status >> word)
+        if (word == "VmHWM:")
+        {
+            size_t peakKb = 0;
+            status >> peakKb;
+            return peakKb;
+        }
+
+    return 0;
+}
+
+// Benchmarked requests sequence.
+struct BenchTrace
+{
+    std::string name_;
+    size_t cacheSize_ = 0;
+    const testPageId_t * ids_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Runs cache created with makeCache over trace and prints results as json line:
+// hits, hit rate, mean time per request, latency percentiles, peak resident memory.
+template <typename MakeCache>
+void benchPolicy( const char * policy, const BenchTrace& trace, MakeCache makeCache )
+{
+    resetPeakRss ();
+
+    // Time of every request is measured for latency histogram...
+    LatencyHistogram histogram {};
+    size_t hitsNum = 0;
+    {
+        auto cache = makeCache ();
+        TestPage::resetMissNum ();
+
+        for (size_t i = 0; i < trace.size_; ++i)
+        {
+            Clock::time_point begin = Clock::now ();
+            cache.getElem (trace.ids_[i]);
+            histogram.add (std::chrono::nanoseconds {Clock::now () - begin}.count ());
+        }
+
+        hitsNum = trace.size_ - TestPage::getMissNum ();
+    }
+
+    // ... and mean time is measured without clock calls overhead.
+    double nsPerOp = 0;
+    {
+        auto cache = makeCache ();
+
+        Clock::time_point begin = Clock::now ();
+        for (size_t i = 0; i < trace.size_; ++i)
+            cache.getElem (trace.ids_[i]);
+        std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+        nsPerOp = trace.size_ == 0 ? 0 : time.count () / trace.size_;
+    }
+
+    std::cout << std::fixed << std::setprecision (4)
+              << "{\"policy\": \"" << policy << "\""
+              << ", \"trace\": \"" << trace.name_ << "\""
+              << ", \"requests\": " << trace.size_
+              << ", \"capacity\": " << trace.cacheSize_
+              << ", \"hits\": " << hitsNum
+              << ", \"hit_rate\": " << (trace.size_ == 0 ? 0. : static_cast<double> (hitsNum) / trace.size_)
+              << std::setprecision (1)
+              << ", \"ns_per_op\": " << nsPerOp
+              << ", \"p50_ns\": " << histogram.getPercentile (0.5)
+              << ", \"p99_ns\": " << histogram.getPercentile (0.99)
+              << ", \"p999_ns\": " << histogram.getPercentile (0.999)
+              << ", \"peak_rss_kb\": " << getPeakRssKb ()
+              << "}" << std::endl;
+}
+
+// Returns ns per lookup for per element getElem loop over trace.
+template <typename Cache>
+double timeElemLookups( Cache& cache, const std::vector<testPageId_t>& trace )
+{
+    Clock::time_point begin = Clock::now ();
+    for (testPageId_t id : trace)
+        cache.getElem (id);
+    std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+    return time.count () / trace.size ();
+}
+
+// Returns ns per lookup for getElems over trace splitted in batchSize batches.
+template <typename Cache>
+double timeBatchLookups( Cache& cache, const std::vector<testPageId_t>& trace, size_t batchSize )
+{
+    std::vector<BenchPage> elems (batchSize, BenchPage {0});
+
+    Clock::time_point begin = Clock::now ();
+    for (size_t batchBegin = 0; batchBegin < trace.size (); batchBegin += batchSize)
+        cache.getElems (trace.data () + batchBegin, std::min (batchSize, trace.size () - batchBegin), elems.data ());
+    std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+    return time.count () / trace.size ();
+}
+
+// Prints per element & batch lookups time for caches created with makeCache.
+// Caches are warmed up with the trace first.
+template <typename MakeCache>
+void benchBatch( const char * policy, const std::vector<testPageId_t>& trace, size_t batchSize, MakeCache makeCache )
+{
+    double elemNs = 0;
+    {
+        auto cache = makeCache ();
+        timeElemLookups (cache, trace);
+        elemNs = timeElemLookups (cache, trace);
+    }
+
+    double batchNs = 0;
+    {
+        auto cache = makeCache ();
+        timeBatchLookups (cache, trace, batchSize);
+        batchNs = timeBatchLookups (cache, trace, batchSize);
+    }
+
+    std::cout << std::setw (8) << policy << std::fixed << std::setprecision (1)
+              << std::setw (16) << elemNs << std::setw (16) << batchNs
+              << std::setprecision (2) << std::setw (10) << elemNs / batchNs << std::endl;
+}
+
+// New policies should be added here.
+void benchAllPolicies( const BenchTrace& trace )
+{
+    benchPolicy ("opt", trace, [&trace]
+        { return CacheBelady<TestPage, testPageId_t> {trace.cacheSize_, trace.ids_, trace.size_}; });
+    benchPolicy ("lru", trace, [&trace]
+        { return CacheLRU<TestPage, testPageId_t> {trace.cacheSize_}; });
+    benchPolicy ("clock", trace, [&trace]
+        { return CacheClock<TestPage, testPageId_t> {trace.cacheSize_}; });
+    benchPolicy ("clock-pro", trace, [&trace]
+        { return CacheClockPro<TestPage, testPageId_t> {trace.cacheSize_}; });
+    benchPolicy ("policy-lru", trace, [&trace]
+        { return PolicyCache<TestPage, testPageId_t> {trace.cacheSize_}; });
+    benchPolicy ("policy-fifo", trace, [&trace]
+        { return PolicyCache<TestPage, testPageId_t, FifoEviction> {trace.cacheSize_}; });
+    benchPolicy ("policy-clock", trace, [&trace]
+        { return PolicyCache<TestPage, testPageId_t, ClockEviction> {trace.cacheSize_}; });
+    benchPolicy ("2q", trace, [&trace]
+        { return Cache2Q<TestPage, testPageId_t> {trace.cacheSize_}; });
+    benchPolicy ("2q-tinylfu", trace, [&trace]
+        { return Cache2Q<TestPage, testPageId_t> {trace.cacheSize_, true}; });
+    benchPolicy ("adaptive-2q", trace, [&trace]
+        { return CacheAdaptive2Q<TestPage, testPageId_t> {trace.cacheSize_}; });
+}
+
+} // namespace
+
+void benchPolicies( int tracesNum, char ** traceFilenames )
+{
+    static constexpr size_t REQUESTS_NUM = 1000000;
+    static constexpr size_t KEYS_NUM = 100000;
+    static constexpr size_t CAPACITY = 10000;
+    static constexpr std::uint64_t SEED = 0;
+
+    std::vector<std::pair<std::string, std::vector<testPageId_t>>> generated {};
+
+    for (double skew : {0.7, 0.99, 1.2})
+        generated.emplace_back ("zipf-" + std::to_string (skew).substr (0, 4),
+                                genZipfTrace (REQUESTS_NUM, KEYS_NUM, skew, SEED));
+    generated.emplace_back ("scan", genScanTrace (REQUESTS_NUM, KEYS_NUM, 0.99, CAPACITY, 2 * CAPACITY, SEED));
+    generated.emplace_back ("loop-small", genLoopTrace (REQUESTS_NUM, CAPACITY / 2));
+    generated.emplace_back ("loop-big", genLoopTrace (REQUESTS_NUM, 2 * CAPACITY));
+    generated.emplace_back ("shifting", genShiftingTrace (REQUESTS_NUM, KEYS_NUM, 0.99, 10, SEED));
+
+    for (const auto& [name, ids] : generated)
+        benchAllPolicies (BenchTrace {name, CAPACITY, ids.data (), ids.size ()});
+
+    // Recorded traces: binary traces are mapped, text ones are read.
+    for (int i = 0; i < tracesNum; ++i)
+    {
+        MappedTrace mapped {traceFilenames[i]};
+        if (mapped.isValid ())
+        {
+            benchAllPolicies (BenchTrace {traceFilenames[i], mapped.getCacheSize (), mapped.ids (), mapped.size ()});
+            continue;
+        }
+
+        std::ifstream in {traceFilenames[i]};
+        if (!in.is_open ())
+        {
+            std::cerr << "Cannot open file " << traceFilenames[i] << std::endl;
+            continue;
+        }
+        TestTrace text = readTrace (in);
+        benchAllPolicies (BenchTrace {traceFilenames[i], text.cacheSize_, text.ids_.data (), text.ids_.size ()});
+    }
+}
+
+void benchShardedThroughput()
+{
+    static constexpr size_t CAPACITY = 100000;
+    static constexpr size_t KEYS_NUM = 1000000;
+    static constexpr double SKEW = 0.99;
+    static constexpr size_t REQUESTS_PER_THREAD = 1000000;
+
+    std::vector<size_t> threadsNums = getThreadsNums ();
+
+    std::vector<std::vector<testPageId_t>> traces {};
+    for (size_t threadId = 0; threadId < threadsNums.back (); ++threadId)
+        traces.push_back (genZipfTrace (REQUESTS_PER_THREAD, KEYS_NUM, SKEW, threadId));
+
+    std::cout << "Zipf trace: " << KEYS_NUM << " keys, skew " << SKEW << ", "
+              << REQUESTS_PER_THREAD << " requests per thread, cache capacity " << CAPACITY << std::endl;
+    std::cout << std::setw (8) << "threads" << std::setw (20) << "sharded (op/s)"
+              << std::setw (20) << "global lock (op/s)" << std::endl;
+
+    for (size_t threadsNum : threadsNums)
+    {
+        ShardedCache2Q<BenchPage, testPageId_t> sharded {CAPACITY};
+        double shardedRate = runThreads (traces, threadsNum,
+            [&sharded]( testPageId_t id ) { sharded.getElem (id); });
+
+        std::mutex globalMutex {};
+        Cache2Q<BenchPage, testPageId_t> global {CAPACITY};
+        double globalRate = runThreads (traces, threadsNum,
+            [&globalMutex, &global]( testPageId_t id )
+            {
+                std::lock_guard<std::mutex> lock {globalMutex};
+                global.getElem (id);
+            });
+
+        std::cout << std::setw (8) << threadsNum << std::fixed << std::setprecision (0)
+                  << std::setw (20) << shardedRate << std::setw (20) << globalRate << std::endl;
+    }
+}
+
+void benchReadMostly()
+{
+    static constexpr size_t CAPACITY = 100000;
+    // Hot set fits in cache, so almost all lookups are hits.
+    static constexpr size_t KEYS_NUM = CAPACITY / 2;
+    static constexpr double SKEW = 0.99;
+    static constexpr size_t REQUESTS_PER_THREAD = 2000000;
+
+    std::vector<size_t> threadsNums = getThreadsNums ();
+
+    std::vector<std::vector<testPageId_t>> traces {};
+    for (size_t threadId = 0; threadId < threadsNums.back (); ++threadId)
+        traces.push_back (genZipfTrace (REQUESTS_PER_THREAD, KEYS_NUM, SKEW, threadId));
+
+    std::cout << "Zipf trace: " << KEYS_NUM << " keys, skew " << SKEW << ", "
+              << REQUESTS_PER_THREAD << " requests per thread, cache capacity " << CAPACITY << std::endl;
+    std::cout << std::setw (8) << "threads" << std::setw (20) << "epoch lru (op/s)"
+              << std::setw (20) << "sharded (op/s)" << std::setw (20) << "locked lru (op/s)" << std::endl;
+
+    for (size_t threadsNum : threadsNums)
+    {
+        ConcurrentCacheLRU<BenchPage, testPageId_t> concurrent {CAPACITY};
+        std::vector<std::unique_ptr<ConcurrentCacheLRU<BenchPage, testPageId_t>::Reader>> readers {};
+        for (size_t threadId = 0; threadId < threadsNum; ++threadId)
+            readers.push_back (concurrent.getReader ());
+
+        // Warm up to measure hits only.
+        for (testPageId_t id = 0; id < KEYS_NUM; ++id)
+            readers[0]->getElem (id);
+        double concurrentRate = runThreads (traces, threadsNum,
+            [&readers]( size_t threadId, testPageId_t id ) { readers[threadId]->getElem (id); });
+
+        ShardedCache2Q<BenchPage, testPageId_t> sharded {CAPACITY};
+        for (testPageId_t id = 0; id < KEYS_NUM; ++id)
+            sharded.getElem (id);
+        double shardedRate = runThreads (traces, threadsNum,
+            [&sharded]( testPageId_t id ) { sharded.getElem (id); });
+
+        PolicyCache<BenchPage, testPageId_t, LruEviction, FlatIndex<testPageId_t>, FlatValues<BenchPage>, Locked>
+            locked {CAPACITY};
+        for (testPageId_t id = 0; id < KEYS_NUM; ++id)
+            locked.getElem (id);
+        double lockedRate = runThreads (traces, threadsNum,
+            [&locked]( testPageId_t id ) { locked.getElem (id); });
+
+        std::cout << std::setw (8) << threadsNum << std::fixed << std::setprecision (0) << std::setw (20)
+                  << concurrentRate << std::setw (20) << shardedRate << std::setw (20) << lockedRate << std::endl;
+    }
+}
+
+void benchBatchLookup()
+{
+    // About 300 MB of nodes & buckets for each cache.
+    static constexpr size_t CAPACITY = 1 << 22;
+    static constexpr size_t KEYS_NUM = 2 * CAPACITY;
+    static constexpr double SKEW = 0.8;
+    static constexpr size_t REQUESTS_NUM = 4000000;
+    static constexpr size_t BATCH_SIZE = 256;
+
+    std::vector<testPageId_t> trace = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    std::cout << "Zipf trace: " << KEYS_NUM << " keys, skew " << SKEW << ", " << REQUESTS_NUM
+              << " requests, cache capacity " << CAPACITY << ", batch size " << BATCH_SIZE << std::endl;
+    std::cout << std::setw (8) << "policy" << std::setw (16) << "getElem (ns)"
+              << std::setw (16) << "getElems (ns)" << std::setw (10) << "speedup" << std::endl;
+
+    benchBatch ("lru", trace, BATCH_SIZE, []
+        { return CacheLRU<BenchPage, testPageId_t> {CAPACITY}; });
+    benchBatch ("2q", trace, BATCH_SIZE, []
+        { return Cache2Q<BenchPage, testPageId_t> {CAPACITY}; });
+}
+
+void benchTtlLookup()
+{
+    static constexpr size_t CAPACITY = 1 << 16;
+    static constexpr size_t KEYS_NUM = 4 * CAPACITY;
+    static constexpr double SKEW = 0.9;
+    static constexpr size_t REQUESTS_NUM = 8000000;
+    static constexpr std::chrono::milliseconds TTL {50};
+    static constexpr std::chrono::milliseconds TICK {1};
+
+    std::vector<testPageId_t> trace = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    std::cout << "Zipf trace: " << KEYS_NUM << " keys, skew " << SKEW << ", " << REQUESTS_NUM
+              << " requests, cache capacity " << CAPACITY << ", ttl " << TTL.count () << " ms" << std::endl;
+    std::cout << std::setw (16) << "cache" << std::setw (12) << "ns/op" << std::setw (12) << "hit rate" << std::endl;
+
+    auto printResult = []( const char * name, double ns, size_t hitsNum )
+    {
+        std::cout << std::setw (16) << name << std::fixed << std::setprecision (1) << std::setw (12) << ns
+                  << std::setprecision (3) << std::setw (12) << double (hitsNum) / REQUESTS_NUM << std::endl;
+    };
+
+    // Load time is checked on each hit & stale element is reloaded.
+    {
+        CacheLRU<StampedPage, testPageId_t> cache {CAPACITY};
+        size_t hitsNum = 0;
+
+        Clock::time_point begin = Clock::now ();
+        for (testPageId_t id : trace)
+        {
+            bool isCached = cache.isCached (id);
+            const StampedPage& page = cache.getElem (id);
+
+            if (Clock::now () - page.loadTime_ >= TTL)
+                cache.addElem ({StampedPage {id}, id});
+            else
+                hitsNum += isCached;
+        }
+        std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+        printResult ("lru + stamps", time.count () / REQUESTS_NUM, hitsNum);
+    }
+
+    {
+        CoarseClock clock {TICK};
+        CacheTtlLRU<BenchPage, testPageId_t> cache {CAPACITY, TTL / TICK, &clock};
+        size_t hitsNum = 0;
+
+        Clock::time_point begin = Clock::now ();
+        for (testPageId_t id : trace)
+        {
+            hitsNum += cache.isCached (id);
+            cache.getElem (id);
+        }
+        std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+        printResult ("ttl lru", time.count () / REQUESTS_NUM, hitsNum);
+    }
+}
+
+void benchTieredCache()
+{
+    static constexpr size_t MEMORY_CAPACITY = 1 << 15;
+    static constexpr size_t KEYS_NUM = 16 * MEMORY_CAPACITY;
+    static constexpr size_t DISK_CAPACITY = 12 * MEMORY_CAPACITY;
+    static constexpr double SKEW = 0.7;
+    static constexpr size_t REQUESTS_NUM = 4000000;
+
+    std::vector<testPageId_t> trace = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+    std::string diskFilename = (std::filesystem::temp_directory_path () / "cache-bench-tier.log").string ();
+
+    std::cout << "Zipf trace: " << KEYS_NUM << " keys, skew " << SKEW << ", " << REQUESTS_NUM
+              << " requests, memory capacity " << MEMORY_CAPACITY << ", disk capacity " << DISK_CAPACITY
+              << ", disk file " << diskFilename << std::endl;
+    std::cout << std::setw (12) << "cache" << std::setw (16) << "memory hits" << std::setw (16) << "disk hits"
+              << std::setw (16) << "backend loads" << std::setw (12) << "ns/op" << std::endl;
+
+    auto printResult = []( const char * name, size_t memoryHitsNum, size_t diskHitsNum, size_t loadsNum, double ns )
+    {
+        std::cout << std::setw (12) << name << std::setw (16) << memoryHitsNum << std::setw (16) << diskHitsNum
+                  << std::setw (16) << loadsNum << std::fixed << std::setprecision (1) << std::setw (12) << ns << std::endl;
+    };
+
+    {
+        Cache2Q<BenchPage, testPageId_t> cache {MEMORY_CAPACITY};
+
+        Clock::time_point begin = Clock::now ();
+        for (testPageId_t id : trace)
+            cache.getElem (id);
+        std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+        size_t loadsNum = cache.getMetrics ()[CacheMetrics::MISSES];
+        printResult ("2q", REQUESTS_NUM - loadsNum, 0, loadsNum, time.count () / REQUESTS_NUM);
+    }
+
+    {
+        TieredCache2Q<BenchPage, testPageId_t> cache {MEMORY_CAPACITY, diskFilename.c_str (), DISK_CAPACITY};
+        if (!cache.isValid ())
+        {
+            std::cout << "Cannot open file " << diskFilename << std::endl;
+            return;
+        }
+
+        Clock::time_point begin = Clock::now ();
+        for (testPageId_t id : trace)
+            cache.getElem (id);
+        std::chrono::duration<double, std::nano> time = Clock::now () - begin;
+
+        TieredCache2Q<BenchPage, testPageId_t>::Stats stats = cache.getStats ();
+        printResult ("2q + disk", stats.memoryHitsNum_, stats.diskHitsNum_, stats.loadsNum_,
+                     time.count () / REQUESTS_NUM);
+    }
+    std::filesystem::remove (diskFilename);
+}
+
+void benchAsyncLoader()
+{
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr double SKEW = 0.99;
+    static constexpr size_t THREADS_NUM = 16;
+    static constexpr size_t REQUESTS_PER_THREAD = 500;
+    static constexpr size_t SHARDS_NUM = 4;
+    static constexpr size_t LOADER_WORKERS_NUM = 16;
+
+    // Threads request the same ids at about the same time, like clients of
+    // one popular resource do, so many misses are concurrent.
+    std::vector<std::vector<testPageId_t>> traces (THREADS_NUM,
+        genZipfTrace (REQUESTS_PER_THREAD, KEYS_NUM, SKEW, 0));
+
+    std::cout << "Same Zipf trace for each thread: " << KEYS_NUM << " keys, skew " << SKEW << ", " << THREADS_NUM << " threads x "
+              << REQUESTS_PER_THREAD << " requests, cache capacity " << CAPACITY << ", load latency "
+              << SlowPage::LOAD_LATENCY.count () << " us" << std::endl;
+    std::cout << std::setw (18) << "mode" << std::setw (14) << "backend calls" << std::setw (12) << "p50 (us)"
+              << std::setw (12) << "p99 (us)" << std::setw (12) << "p999 (us)" << std::setw (12) << "max (us)"
+              << std::endl;
+
+    {
+        // Miss is loaded under shard lock.
+        ShardedCache2Q<SlowPage, testPageId_t> cache {CAPACITY, SHARDS_NUM};
+        runLatencyTest ("locked load", traces, [&cache]( testPageId_t id ) { cache.getElem (id); });
+    }
+    {
+        // Miss is loaded without lock, concurrent misses are loaded separately.
+        ShardedCache2Q<SlowPage, testPageId_t> cache {CAPACITY, SHARDS_NUM};
+        runLatencyTest ("unlocked load", traces, [&cache]( testPageId_t id )
+        {
+            if (!cache.findElem (id))
+                cache.addLoaded (id, SlowPage {id});
+        });
+    }
+    {
+        ShardedCache2Q<SlowPage, testPageId_t> cache {CAPACITY, SHARDS_NUM};
+        AsyncLoader<SlowPage, testPageId_t> loader {[]( testPageId_t id ) { return SlowPage {id}; },
+                                                    LOADER_WORKERS_NUM};
+        // Metrics are dumped to stderr, so stdout table is kept clean.
+        MetricsDumper dumper {[&cache] { return cache.getMetrics (); }, std::cerr, "async coalesced",
+                              std::chrono::milliseconds {100}};
+        runLatencyTest ("async coalesced", traces, [&cache, &loader]( testPageId_t id )
+        {
+            cache.getElemAsync (id, loader).wait ();
+        });
+        std::cout << "Coalesced loads: " << loader.getCoalescedNum () << std::endl;
+    }
+}
+
+} // namespace caches
@@ -0,0 +1,134 @@
+#include <cstring>
+
+#include "cache-gen.hh"
+#include "cache-mrc.hh"
+#include "cache-trace.hh"
+
+namespace
+{
+
+// Positional argument or default value.
+double getArg( int argc, char ** argv, int argId, double defaultVal )
+{
+    return argc > argId ? std::strtod (argv[argId], nullptr) : defaultVal;
+}
+
+// Seed argument, 0 by default.
+std::uint64_t getSeed( int argc, char ** argv, int argId )
+{
+    return argc > argId ? std::strtoull (argv[argId], nullptr, 10) : 0;
+}
+
+// Reads binary or text trace ids. Returns false if file can't be read.
+bool readIds( const char * filename, std::vector<caches::testPageId_t>& ids, size_t& cacheSize )
+{
+    caches::MappedTrace mapped {filename};
+    if (mapped.isValid ())
+    {
+        ids.assign (mapped.ids (), mapped.ids () + mapped.size ());
+        cacheSize = mapped.getCacheSize ();
+        return true;
+    }
+
+    std::ifstream in {filename};
+    if (!in.is_open ())
+        return false;
+
+    caches::TestTrace trace = caches::readTrace (in);
+    ids = std::move (trace.ids_);
+    cacheSize = trace.cacheSize_;
+
+    return true;
+}
+
+} // namespace
+
+int main( int argc, char ** argv )
+{
+    static const char USAGE[] =
+        "Usage: cache-gen <MODEL> <BINARY TRACE> <REQUESTS NUM> <CACHE CAPACITY> [MODEL ARGS] [SEED]\n"
+        "       cache-gen replay <BINARY TRACE> <REQUESTS NUM> <SOURCE TRACE> [SEED]\n"
+        "       cache-gen analyze <TRACE FILE>\n"
+        "Models:\n"
+        "    zipf  <KEYS NUM> <SKEW>                          - Zipf distributed ids\n"
+        "    scan  <KEYS NUM> <SKEW> <SCAN PERIOD> <SCAN LEN> - Zipf mixed with one-time scans\n"
+        "    shift <KEYS NUM> <SKEW> <PHASES NUM>             - Zipf with working set changed each phase\n"
+        "    loop  <LOOP LEN>                                 - cyclic ids\n"
+        "    replay                                           - ids popularity of source trace (binary or text),\n"
+        "                                                       capacity is taken from it\n"
+        "Seed is 0 by default, the same arguments give the same trace.\n"
+        "analyze prints requests, distinct ids & reuse distances histogram of trace (binary or text).\n";
+
+    if (argc < 3)
+    {
+        std::cout << USAGE;
+        return 1;
+    }
+
+    if (!std::strcmp (argv[1], "analyze"))
+    {
+        std::vector<caches::testPageId_t> ids {};
+        size_t cacheSize = 0;
+        if (!readIds (argv[2], ids, cacheSize))
+        {
+            std::cout << "Cannot open file " << argv[2] << std::endl;
+            return 1;
+        }
+
+        caches::printTraceStats (caches::getTraceStats (ids.data (), ids.size ()));
+        return 0;
+    }
+
+    if (argc < 5)
+    {
+        std::cout << USAGE;
+        return 1;
+    }
+
+    const char * binFilename = argv[2];
+    size_t requestsNum = std::strtoull (argv[3], nullptr, 10);
+    size_t cacheSize = 0;
+    std::vector<caches::testPageId_t> trace {};
+
+    if (!std::strcmp (argv[1], "replay"))
+    {
+        std::vector<caches::testPageId_t> sourceIds {};
+        if (!readIds (argv[4], sourceIds, cacheSize))
+        {
+            std::cout << "Cannot open file " << argv[4] << std::endl;
+            return 1;
+        }
+
+        trace = caches::genReplayTrace (sourceIds.data (), sourceIds.size (), requestsNum, getSeed (argc, argv, 5));
+    }
+    else
+    {
+        cacheSize = std::strtoull (argv[4], nullptr, 10);
+        size_t keysNum = getArg (argc, argv, 5, 0);
+        double skew = getArg (argc, argv, 6, 0);
+
+        if (!std::strcmp (argv[1], "zipf") && argc >= 7)
+            trace = caches::genZipfTrace (requestsNum, keysNum, skew, getSeed (argc, argv, 7));
+        else if (!std::strcmp (argv[1], "scan") && argc >= 9)
+            trace = caches::genScanTrace (requestsNum, keysNum, skew, getArg (argc, argv, 7, 0),
+                                          getArg (argc, argv, 8, 0), getSeed (argc, argv, 9));
+        else if (!std::strcmp (argv[1], "shift") && argc >= 8)
+            trace = caches::genShiftingTrace (requestsNum, keysNum, skew, getArg (argc, argv, 7, 0),
+                                              getSeed (argc, argv, 8));
+        else if (!std::strcmp (argv[1], "loop") && argc >= 6)
+            trace = caches::genLoopTrace (requestsNum, keysNum);
+        else
+        {
+            std::cout << USAGE;
+            return 1;
+        }
+    }
+
+    if (!caches::writeTrace (binFilename, cacheSize, trace.data (), trace.size ()))
+    {
+        std::cout << "Cannot write file " << binFilename << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
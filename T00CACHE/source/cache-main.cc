@@ -1,7 +1,41 @@
+#include <cstring>
 
 #include "cache-tests.hh"
+#include "cache-trace.hh"
 
-int main()
+int main( int argc, char ** argv )
 {
+    // Hit rates of OPT, LRU and 2Q side by side.
+    if (argc > 1 && !std::strcmp (argv[1], "--cmp"))
+    {
+        caches::cmpEfficiency ();
+        return 0;
+    }
+
+    // Byte budgeted LRU and 2Q with per id sizes & costs.
+    if (argc > 1 && !std::strcmp (argv[1], "--sized"))
+    {
+        caches::cmpSizedEfficiency ();
+        return 0;
+    }
+
+    // Text trace to binary trace.
+    if (argc > 3 && !std::strcmp (argv[1], "--convert"))
+    {
+        if (!caches::convertTrace (argv[2], argv[3]))
+        {
+            std::cout << "Cannot convert " << argv[2] << " to " << argv[3] << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // 2Q hits on memory mapped binary trace.
+    if (argc > 2 && !std::strcmp (argv[1], "--replay"))
+    {
+        std::cout << caches::replayBinTrace (argv[2]) << std::endl;
+        return 0;
+    }
+
     std::cout << caches::test2QEfficiency () << std::endl;
-}
\ No newline at end of file
+}
@@ -0,0 +1,42 @@
+#include <thread>
+
+#include "cache-mrc.hh"
+#include "cache-trace.hh"
+
+int main( int argc, char ** argv )
+{
+    static const char USAGE[] =
+        "Usage: cache-mrc <TRACE FILE> [MAX CAPACITY] [2Q POINTS NUM] [THREADS NUM]\n"
+        "    Trace is binary (see cache-trace.hh) or text: <CACHE CAPACITY> <SEQUENCE SIZE> <SEQUENCE>.\n"
+        "    Prints LRU hit rate for each capacity up to max capacity (distinct ids number by default)\n"
+        "    and 2Q hit rate for log distributed capacities (32 by default) in csv format.\n";
+
+    if (argc < 2)
+    {
+        std::cout << USAGE;
+        return 1;
+    }
+
+    size_t maxCapacity = argc > 2 ? std::strtoull (argv[2], nullptr, 10) : 0;
+    size_t pointsNum = argc > 3 ? std::strtoull (argv[3], nullptr, 10) : 32;
+    size_t threadsNum = argc > 4 ? std::strtoull (argv[4], nullptr, 10) : std::thread::hardware_concurrency ();
+
+    // Binary traces are mapped, text ones are read.
+    caches::MappedTrace mapped {argv[1]};
+    if (mapped.isValid ())
+    {
+        caches::printMissRatioCurves (mapped.ids (), mapped.size (), maxCapacity, pointsNum, threadsNum);
+        return 0;
+    }
+
+    std::ifstream in {argv[1]};
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << argv[1] << std::endl;
+        return 1;
+    }
+    caches::TestTrace trace = caches::readTrace (in);
+    caches::printMissRatioCurves (trace.ids_.data (), trace.ids_.size (), maxCapacity, pointsNum, threadsNum);
+
+    return 0;
+}
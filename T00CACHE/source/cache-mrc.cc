@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include "cache-mrc.hh"
+
+namespace caches
+{
+
+namespace
+{
+
+// Fenwick tree of marks on requests positions.
+class MarksTree
+{
+    std::vector<std::uint32_t> tree_;
+
+public:
+
+    MarksTree( size_t size ) :
+        tree_ (size + 1)
+    {}
+
+    void add( size_t pos, int delta )
+    {
+        for (++pos; pos < tree_.size (); pos += pos & -pos)
+            tree_[pos] += delta;
+    }
+
+    // Number of marks in [0, pos).
+    size_t count( size_t pos ) const
+    {
+        size_t sum = 0;
+        for (; pos > 0; pos -= pos & -pos)
+            sum += tree_[pos];
+
+        return sum;
+    }
+};
+
+// Loads are not simulated, only hits are counted.
+struct NoPage
+{
+    NoPage( testPageId_t ) {}
+};
+
+} // namespace
+
+StackDistances::StackDistances( const testPageId_t * ids, size_t idsNum, size_t maxCapacity ) :
+    hitsNum_ (maxCapacity + 1),
+    requestsNum_ (idsNum)
+{
+    assert (ids != nullptr || idsNum == 0);
+
+    // Distances histogram first.
+    std::vector<size_t> distancesNum (maxCapacity);
+    std::unordered_map<testPageId_t, size_t> lastPos {};
+    MarksTree marks {idsNum};
+
+    for (size_t pos = 0; pos < idsNum; ++pos)
+    {
+        auto [lastIt, isNew] = lastPos.try_emplace (ids[pos], pos);
+
+        if (!isNew)
+        {
+            size_t distance = marks.count (pos) - marks.count (lastIt->second + 1);
+            if (distance < maxCapacity)
+                ++distancesNum[distance];
+
+            marks.add (lastIt->second, -1);
+            lastIt->second = pos;
+        }
+
+        marks.add (pos, 1);
+    }
+    distinctIdsNum_ = lastPos.size ();
+
+    for (size_t capacity = 1; capacity <= maxCapacity; ++capacity)
+        hitsNum_[capacity] = hitsNum_[capacity - 1] + distancesNum[capacity - 1];
+}
+
+size_t StackDistances::getRequestsNum() const
+{
+    return requestsNum_;
+}
+
+size_t StackDistances::getDistinctIdsNum() const
+{
+    return distinctIdsNum_;
+}
+
+size_t StackDistances::getMaxCapacity() const
+{
+    return hitsNum_.size () - 1;
+}
+
+size_t StackDistances::getLruHits( size_t capacity ) const
+{
+    assert (capacity < hitsNum_.size ());
+
+    return hitsNum_[capacity];
+}
+
+std::vector<size_t> sample2QHits( const testPageId_t * ids, size_t idsNum,
+                                  const std::vector<size_t>& capacities, size_t threadsNum )
+{
+    std::vector<size_t> hitsNums (capacities.size ());
+    // Next capacity to simulate.
+    std::atomic<size_t> nextId {0};
+
+    auto simulate = [&]
+    {
+        for (size_t capacityId = nextId++; capacityId < capacities.size (); capacityId = nextId++)
+        {
+            Cache2Q<NoPage, testPageId_t> cache { capacities[capacityId] };
+            size_t hitsNum = 0;
+
+            for (size_t i = 0; i < idsNum; ++i)
+            {
+                if (cache.findElem (ids[i]))
+                    ++hitsNum;
+                else
+                    cache.addLoaded (ids[i], NoPage {ids[i]});
+            }
+
+            hitsNums[capacityId] = hitsNum;
+        }
+    };
+
+    std::vector<std::thread> threads {};
+    for (size_t threadId = 0; threadId < std::max<size_t> (threadsNum, 1); ++threadId)
+        threads.emplace_back (simulate);
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    return hitsNums;
+}
+
+std::vector<size_t> getLogCapacities( size_t minCapacity, size_t maxCapacity, size_t pointsNum )
+{
+    std::vector<size_t> capacities {};
+    if (minCapacity > maxCapacity || pointsNum == 0)
+        return capacities;
+
+    double ratio = pointsNum == 1 ? 1 : std::pow (double (maxCapacity) / minCapacity, 1.0 / (pointsNum - 1));
+    double capacity = minCapacity;
+
+    for (size_t i = 0; i < pointsNum; ++i, capacity *= ratio)
+    {
+        size_t rounded = std::min<size_t> (std::llround (capacity), maxCapacity);
+
+        // Close small capacities are rounded to the same value.
+        if (capacities.empty () || capacities.back () < rounded)
+            capacities.push_back (rounded);
+    }
+
+    return capacities;
+}
+
+void printMissRatioCurves( const testPageId_t * ids, size_t idsNum,
+                           size_t maxCapacity, size_t pointsNum, size_t threadsNum )
+{
+    // Distinct ids number is the biggest useful capacity.
+    if (maxCapacity == 0)
+    {
+        std::vector<testPageId_t> sorted (ids, ids + idsNum);
+        std::sort (sorted.begin (), sorted.end ());
+        maxCapacity = std::unique (sorted.begin (), sorted.end ()) - sorted.begin ();
+    }
+
+    auto hitRate = [idsNum]( size_t hitsNum ) { return idsNum == 0 ? 0 : double (hitsNum) / idsNum; };
+
+    std::cout << "policy,capacity,hits,hit_rate" << std::endl;
+
+    StackDistances distances {ids, idsNum, maxCapacity};
+    for (size_t capacity = 1; capacity <= maxCapacity; ++capacity)
+    {
+        size_t hitsNum = distances.getLruHits (capacity);
+        std::cout << "lru," << capacity << "," << hitsNum << "," << hitRate (hitsNum) << "\n";
+    }
+
+    std::vector<size_t> capacities =
+        getLogCapacities (Cache2Q<NoPage, testPageId_t>::MIN_CAPACITY_, maxCapacity, pointsNum);
+    std::vector<size_t> hitsNums = sample2QHits (ids, idsNum, capacities, threadsNum);
+
+    for (size_t i = 0; i < capacities.size (); ++i)
+        std::cout << "2q," << capacities[i] << "," << hitsNums[i] << "," << hitRate (hitsNums[i]) << "\n";
+
+    std::cout.flush ();
+}
+
+TraceStats getTraceStats( const testPageId_t * ids, size_t idsNum )
+{
+    TraceStats stats {};
+    stats.requestsNum_ = idsNum;
+
+    std::vector<testPageId_t> sorted (ids, ids + idsNum);
+    std::sort (sorted.begin (), sorted.end ());
+
+    for (auto it = sorted.begin (); it != sorted.end ();)
+    {
+        auto nextIt = std::upper_bound (it, sorted.end (), *it);
+        ++stats.distinctIdsNum_;
+        stats.onceIdsNum_ += nextIt - it == 1;
+        it = nextIt;
+    }
+
+    // All distances are below distinct ids number.
+    StackDistances distances {ids, idsNum, stats.distinctIdsNum_};
+    size_t maxCapacity = distances.getMaxCapacity ();
+
+    for (size_t begin = 0; begin < maxCapacity; begin = std::max<size_t> (begin * 2, 1))
+    {
+        size_t end = std::min<size_t> (std::max<size_t> (begin * 2, 1), maxCapacity);
+        stats.reusesNum_.push_back (distances.getLruHits (end) - distances.getLruHits (begin));
+    }
+
+    return stats;
+}
+
+void printTraceStats( const TraceStats& stats )
+{
+    std::cout << "requests: " << stats.requestsNum_ << "\n";
+    std::cout << "distinct ids: " << stats.distinctIdsNum_ << "\n";
+    std::cout << "ids requested once: " << stats.onceIdsNum_ << "\n";
+    std::cout << "min_distance,max_distance,reuses,reuses_share" << "\n";
+
+    size_t reusesNum = stats.requestsNum_ - stats.distinctIdsNum_;
+    for (size_t k = 0; k < stats.reusesNum_.size (); ++k)
+    {
+        size_t minDistance = k == 0 ? 0 : size_t {1} << (k - 1);
+        size_t maxDistance = k == 0 ? 0 : (size_t {1} << k) - 1;
+
+        std::cout << minDistance << "," << maxDistance << "," << stats.reusesNum_[k] << ",";
+        std::cout << (reusesNum == 0 ? 0 : double (stats.reusesNum_[k]) / reusesNum) << "\n";
+    }
+
+    std::cout.flush ();
+}
+
+} // namespace caches
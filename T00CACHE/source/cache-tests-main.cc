@@ -1,10 +1,40 @@
 
 #include "cache-tests.hh"
+#include "cache-trace.hh"
 
 int main( int argc, char ** argv )
 {
     for (int i = 1; i < argc; i++)
+    {
+        // Generated binary traces are too big for per capacity tests.
+        if (caches::MappedTrace {argv[i]}.isValid ())
+        {
+            caches::testGeneratedTrace (argv[i]);
+            continue;
+        }
+
         caches::test2QEfficiency (argv[i]);
+        caches::testBinTrace (argv[i]);
+        caches::testClockParity (argv[i]);
+        caches::testAdaptive2Q (argv[i]);
+        caches::testSnapshot (argv[i]);
+        caches::testBelady (argv[i]);
+        caches::testStackDistances (argv[i]);
+    }
+
+    caches::testAdmissionFilter ();
+    caches::testTtl ();
+    caches::testTieredCache ();
+    caches::testPolicyCache ();
+    caches::testConcurrentCache ();
+    caches::testClockPolicies ();
+    caches::testBeladyKnownHits ();
+    caches::testAdaptiveSplit ();
+    caches::testBatchLookup ();
+    caches::testSizedCache ();
+    caches::testMetrics ();
+    caches::testShardedCache ();
+    caches::testAsyncLoader ();
 
     return 0;
 }
\ No newline at end of file
@@ -1,4 +1,16 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <list>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cache-gen.hh"
+#include "cache-mrc.hh"
 #include "cache-tests.hh"
+#include "cache-trace.hh"
 
 namespace caches
 {
@@ -20,6 +32,302 @@ size_t TestPage::getMissNum()
     return missCounter_;
 }
 
+std::unordered_map<testPageId_t, std::pair<size_t, double>> SizedTestPage::params_ {};
+size_t SizedTestPage::missCounter_ = 0;
+size_t SizedTestPage::missedBytes_ = 0;
+
+SizedTestPage::SizedTestPage( testPageId_t id ) :
+    id_ (id)
+{
+    ++missCounter_;
+    missedBytes_ += getSize (id);
+}
+
+testPageId_t SizedTestPage::getId() const
+{
+    return id_;
+}
+
+void SizedTestPage::setParams( testPageId_t id, size_t size, double cost )
+{
+    params_[id] = {size, cost};
+}
+
+void SizedTestPage::resetParams()
+{
+    params_.clear ();
+}
+
+size_t SizedTestPage::getSize( testPageId_t id )
+{
+    auto paramsIt = params_.find (id);
+    return paramsIt == params_.end () ? PAGE_SIZE_ : paramsIt->second.first;
+}
+
+double SizedTestPage::getCost( testPageId_t id )
+{
+    auto paramsIt = params_.find (id);
+    return paramsIt == params_.end () ? 1 : paramsIt->second.second;
+}
+
+void SizedTestPage::resetMissNum()
+{
+    missCounter_ = 0;
+    missedBytes_ = 0;
+}
+
+size_t SizedTestPage::getMissNum()
+{
+    return missCounter_;
+}
+
+size_t SizedTestPage::getMissedBytes()
+{
+    return missedBytes_;
+}
+
+namespace
+{
+
+// Prints test result in stdout.
+void printTestResult( size_t expectedHitsNum, size_t hitsNum )
+{
+    static const char SET_FAIL_COLOR[] = "\033[0;31m";
+    static const char SET_PASS_COLOR[] = "\033[0;32m";
+    static const char RESET_COLOR[] = "\033[0m";
+
+    if (expectedHitsNum != hitsNum)
+    {
+        std::cout << SET_FAIL_COLOR;
+        std::cout << "Failed: ";
+        std::cout << "expeced " << expectedHitsNum << " hits, ";
+        std::cout << "but got " << hitsNum << " hits" << std::endl;
+        std::cout << RESET_COLOR;
+        return;
+    }
+    std::cout << SET_PASS_COLOR;
+    std::cout << "Passed: " <<"Hits number = " << hitsNum << std::endl;
+    std::cout << RESET_COLOR;
+}
+
+// Prints in stdout if hitsNum is not below minHitsNum.
+void printMinHitsResult( size_t minHitsNum, size_t hitsNum )
+{
+    static const char SET_FAIL_COLOR[] = "\033[0;31m";
+    static const char SET_PASS_COLOR[] = "\033[0;32m";
+    static const char RESET_COLOR[] = "\033[0m";
+
+    if (hitsNum < minHitsNum)
+    {
+        std::cout << SET_FAIL_COLOR;
+        std::cout << "Failed: ";
+        std::cout << "expeced at least " << minHitsNum << " hits, ";
+        std::cout << "but got " << hitsNum << " hits" << std::endl;
+        std::cout << RESET_COLOR;
+        return;
+    }
+    std::cout << SET_PASS_COLOR;
+    std::cout << "Passed: " << "Hits number = " << hitsNum << " >= " << minHitsNum << std::endl;
+    std::cout << RESET_COLOR;
+}
+
+// Prints in stdout if hitsNum differs from expectedHitsNum by no more than tolerance part of it.
+void printCloseHitsResult( size_t expectedHitsNum, size_t hitsNum, double tolerance )
+{
+    static const char SET_FAIL_COLOR[] = "\033[0;31m";
+    static const char SET_PASS_COLOR[] = "\033[0;32m";
+    static const char RESET_COLOR[] = "\033[0m";
+
+    double maxDiff = tolerance * expectedHitsNum;
+    if (std::max (hitsNum, expectedHitsNum) - std::min (hitsNum, expectedHitsNum) > maxDiff)
+    {
+        std::cout << SET_FAIL_COLOR;
+        std::cout << "Failed: ";
+        std::cout << "expeced " << expectedHitsNum << " +- " << maxDiff << " hits, ";
+        std::cout << "but got " << hitsNum << " hits" << std::endl;
+        std::cout << RESET_COLOR;
+        return;
+    }
+    std::cout << SET_PASS_COLOR;
+    std::cout << "Passed: " << "Hits number = " << hitsNum << " ~ " << expectedHitsNum << std::endl;
+    std::cout << RESET_COLOR;
+}
+
+// Reference CLOCK over frames array, to check CacheClock: new elements take
+// free frames in order, then the frame freed by hand. Returns number of hits.
+size_t countClockModelHits( const testPageId_t * ids, size_t idsNum, size_t capacity )
+{
+    capacity = std::max<size_t> (capacity, 1);
+
+    // Id & reference bit.
+    std::vector<std::pair<testPageId_t, bool>> frames {};
+    std::unordered_map<testPageId_t, size_t> frameIds {};
+    size_t hand = 0;
+    size_t hitsNum = 0;
+
+    for (size_t i = 0; i < idsNum; ++i)
+    {
+        auto frameIt = frameIds.find (ids[i]);
+        if (frameIt != frameIds.end ())
+        {
+            frames[frameIt->second].second = true;
+            ++hitsNum;
+            continue;
+        }
+
+        if (frames.size () < capacity)
+        {
+            frameIds[ids[i]] = frames.size ();
+            frames.emplace_back (ids[i], false);
+            continue;
+        }
+
+        while (frames[hand].second)
+        {
+            frames[hand].second = false;
+            hand = (hand + 1) % capacity;
+        }
+
+        frameIds.erase (frames[hand].first);
+        frames[hand] = {ids[i], false};
+        frameIds[ids[i]] = hand;
+        hand = (hand + 1) % capacity;
+    }
+
+    return hitsNum;
+}
+
+// Page which knows its id, to check elements read from disk.
+struct IdPage
+{
+    testPageId_t id_;
+    char placeHolder_[60] = "";
+
+    IdPage( testPageId_t id ) : id_ (id) {}
+};
+
+// Returns number of hits for getElems over ids splitted in batches.
+// Ids missed several times in one batch are loaded once.
+template <typename Cache>
+size_t countBatchHits( Cache& cache, const std::vector<testPageId_t>& ids, size_t batchSize )
+{
+    std::vector<TestPage> elems (batchSize, TestPage {0});
+    TestPage::resetMissNum ();
+
+    for (size_t begin = 0; begin < ids.size (); begin += batchSize)
+        cache.getElems (ids.data () + begin, std::min (batchSize, ids.size () - begin), elems.data ());
+
+    return ids.size () - TestPage::getMissNum ();
+}
+
+// Returns number of right elements got with getElems over ids splitted in batches.
+template <typename Cache>
+size_t countBatchRightElems( Cache& cache, const std::vector<testPageId_t>& ids, size_t batchSize )
+{
+    std::vector<IdPage> elems (batchSize, IdPage {0});
+    size_t rightNum = 0;
+
+    for (size_t begin = 0; begin < ids.size (); begin += batchSize)
+    {
+        size_t batchNum = std::min (batchSize, ids.size () - begin);
+        cache.getElems (ids.data () + begin, batchNum, elems.data ());
+
+        for (size_t i = 0; i < batchNum; ++i)
+            rightNum += elems[i].id_ == ids[begin + i];
+    }
+
+    return rightNum;
+}
+
+// The same as countBatchHits, but batch is resolved with single element
+// lookups: lookup (id) for all ids in batch order, then add (id) for not
+// found ids in batch order. Lookup returns if id was found.
+template <typename Lookup, typename Add>
+size_t countBatchModelHits( const std::vector<testPageId_t>& ids, size_t batchSize, Lookup lookup, Add add )
+{
+    TestPage::resetMissNum ();
+
+    for (size_t begin = 0; begin < ids.size (); begin += batchSize)
+    {
+        std::vector<testPageId_t> missIds {};
+        for (size_t i = begin; i < std::min (begin + batchSize, ids.size ()); ++i)
+            if (!lookup (ids[i]))
+                missIds.push_back (ids[i]);
+
+        std::unordered_set<testPageId_t> loadedIds {};
+        for (testPageId_t id : missIds)
+            if (loadedIds.insert (id).second)
+                add (id);
+    }
+
+    return ids.size () - TestPage::getMissNum ();
+}
+
+// Runs cache over ids & cmps its metrics with hits & misses got from TestPage:
+// each miss should be one load, and cache should be full after ids, so each
+// miss except the first capacity ones should be an eviction.
+template <typename Cache>
+void printMetricsResult( const char * name, Cache& cache, const std::vector<testPageId_t>& ids, size_t capacity )
+{
+    size_t hitsNum = countHits (cache, ids.data (), ids.size ());
+    size_t missesNum = ids.size () - hitsNum;
+    CacheMetrics::Snapshot metrics = cache.getMetrics ();
+
+    std::cout << "Testing " << name << " metrics on Zipf trace" << std::endl;
+    printTestResult (hitsNum, metrics[CacheMetrics::HITS] + metrics[CacheMetrics::AM_HITS] +
+                              metrics[CacheMetrics::ALIN_HITS] + metrics[CacheMetrics::ALOUT_HITS]);
+    printTestResult (missesNum, metrics[CacheMetrics::MISSES]);
+    printTestResult (missesNum, metrics[CacheMetrics::LOADS]);
+    printTestResult (missesNum - capacity, metrics[CacheMetrics::EVICTIONS]);
+    printMinHitsResult (metrics[CacheMetrics::MAX_LOAD_TIME_NS], metrics[CacheMetrics::LOADS_TIME_NS]);
+}
+
+// Runs sized cache over ids & prints its hits, hit rate & byte hit rate.
+template <typename Cache>
+void printSizedHits( const char * name, Cache& cache, const std::vector<testPageId_t>& ids )
+{
+    SizedTestPage::resetMissNum ();
+
+    size_t requestedBytes = 0;
+    for (testPageId_t id : ids)
+    {
+        requestedBytes += SizedTestPage::getSize (id);
+        cache.getElem (id);
+    }
+
+    size_t hitsNum = ids.size () - SizedTestPage::getMissNum ();
+    size_t hitBytes = requestedBytes - SizedTestPage::getMissedBytes ();
+
+    std::cout << name << " hits: " << hitsNum;
+    std::cout << ", hit rate: " << (ids.empty () ? 0 : double (hitsNum) / ids.size ());
+    std::cout << ", byte hit rate: " << (requestedBytes == 0 ? 0 : double (hitBytes) / requestedBytes);
+    std::cout << std::endl;
+}
+
+// Max number of elements Cache2Q of given capacity keeps: lists have minimum
+// capacities & ALout is unbounded for capacity < 2 (as in list based version).
+size_t get2QMaxSize( size_t capacity, size_t idsNum )
+{
+    if (capacity < 2)
+        return std::max<size_t> (idsNum, 1);
+
+    return std::max (capacity, Cache2Q<TestPage, testPageId_t>::MIN_CAPACITY_);
+}
+
+// Prints in stdout if OPT hits are not below LRU & 2Q ones on the same sequence.
+// OPT is compared with 2Q for the number of elements 2Q really keeps.
+void printOptResults( const testPageId_t * ids, size_t idsNum, size_t capacity,
+                      size_t lruHitsNum, size_t hits2QNum )
+{
+    CacheBelady<TestPage, testPageId_t> opt { capacity, ids, idsNum };
+    printMinHitsResult (lruHitsNum, countHits (opt, ids, idsNum));
+
+    CacheBelady<TestPage, testPageId_t> opt2QSize { get2QMaxSize (capacity, idsNum), ids, idsNum };
+    printMinHitsResult (hits2QNum, countHits (opt2QSize, ids, idsNum));
+}
+
+} // namespace
+
 void test2QEfficiency( const char * filename )
 {
     assert (filename != nullptr);
@@ -39,45 +347,909 @@ void test2QEfficiency( const char * filename )
 
     std::cin.rdbuf (cinbuf);
 
-    static const char SET_FAIL_COLOR[] = "\033[0;31m";
-    static const char SET_PASS_COLOR[] = "\033[0;32m";
-    static const char RESET_COLOR[] = "\033[0m";
-
     std::cout << "Testing with input file " << '\"' << filename << '\"' << std::endl;
-    if (expectedHitsNum != hitsNum)
+    printTestResult (expectedHitsNum, hitsNum);
+}
+
+void testBinTrace( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
     {
-        std::cout << SET_FAIL_COLOR;
-        std::cout << "Failed: ";
-        std::cout << "expeced " << expectedHitsNum << " hits, ";
-        std::cout << "but got " << hitsNum << " hits" << std::endl;
-        std::cout << RESET_COLOR;
+        std::cout << "Cannot open file " << filename <<std::endl;
         return;
     }
-    std::cout << SET_PASS_COLOR;
-    std::cout << "Passed: " <<"Hits number = " << hitsNum << std::endl;
-    std::cout << RESET_COLOR;
+    TestTrace trace = readTrace (in);
+    size_t expectedHitsNum = 0;
+    in >> expectedHitsNum;
+
+    std::string binFilename =
+        (std::filesystem::temp_directory_path () / "cache-test-trace.bin").string ();
+
+    std::cout << "Testing binary trace of input file " << '\"' << filename << '\"' << std::endl;
+    if (!convertTrace (filename, binFilename.c_str ()))
+    {
+        std::cout << "Cannot convert file " << filename << std::endl;
+        return;
+    }
+
+    size_t hitsNum = 0;
+    {
+        MappedTrace mapped {binFilename.c_str ()};
+        if (!mapped.isValid () || mapped.getCacheSize () != trace.cacheSize_ ||
+            !std::equal (trace.ids_.begin (), trace.ids_.end (), mapped.ids (), mapped.ids () + mapped.size ()))
+        {
+            std::cout << "Mapped trace differs from input file" << std::endl;
+            std::filesystem::remove (binFilename);
+            return;
+        }
+
+        Cache2Q<TestPage, testPageId_t> cache { mapped.getCacheSize () };
+        hitsNum = countHits (cache, mapped.ids (), mapped.size ());
+    }
+    std::filesystem::remove (binFilename);
+
+    printTestResult (expectedHitsNum, hitsNum);
 }
 
-size_t test2QEfficiency()
+void testAdmissionFilter()
 {
-    size_t cacheSize = 0;
-    size_t inputSize = 0;
+    static constexpr size_t REQUESTS_NUM = 200000;
+    static constexpr size_t KEYS_NUM = 20000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.9;
 
-    std::cin >> cacheSize >> inputSize;
+    std::vector<std::pair<const char *, std::vector<testPageId_t>>> traces {};
+    traces.emplace_back ("Zipf", genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0));
+    traces.emplace_back ("Zipf with scans", genScanTrace (REQUESTS_NUM, KEYS_NUM, SKEW, CAPACITY, 2 * CAPACITY, 0));
 
-    testPageId_t * pIds = new testPageId_t[inputSize];
-    for (size_t i = 0; i < inputSize; ++i)
-        std::cin >> pIds[i];
+    for (const auto& [name, ids] : traces)
+    {
+        Cache2Q<TestPage, testPageId_t> plain { CAPACITY };
+        Cache2Q<TestPage, testPageId_t> filtered { CAPACITY, true };
+
+        size_t plainHitsNum = countHits (plain, ids.data (), ids.size ());
+        size_t filteredHitsNum = countHits (filtered, ids.data (), ids.size ());
+
+        // Filter should not lose hits on these traces.
+        std::cout << "Testing admission filter on " << name << " trace" << std::endl;
+        printMinHitsResult (plainHitsNum, filteredHitsNum);
+    }
+}
+
+void testClockParity( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << filename <<std::endl;
+        return;
+    }
+    TestTrace trace = readTrace (in);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    CacheClock<TestPage, testPageId_t> clock { trace.cacheSize_ };
+
+    std::cout << "Testing CLOCK vs CLOCK model with input file " << '\"' << filename << '\"' << std::endl;
+    printTestResult (countClockModelHits (ids, idsNum, trace.cacheSize_), countHits (clock, ids, idsNum));
+}
+
+void testClockPolicies()
+{
+    static constexpr size_t REQUESTS_NUM = 200000;
+    static constexpr size_t KEYS_NUM = 20000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.9;
+    // CLOCK is an approximation of LRU, not the same policy.
+    static constexpr double LRU_TOLERANCE = 0.1;
+
+    std::vector<std::pair<const char *, std::vector<testPageId_t>>> traces {};
+    traces.emplace_back ("Zipf", genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0));
+    traces.emplace_back ("Zipf with scans", genScanTrace (REQUESTS_NUM, KEYS_NUM, SKEW, CAPACITY, 2 * CAPACITY, 0));
+
+    for (const auto& [name, ids] : traces)
+    {
+        CacheLRU<TestPage, testPageId_t> lru { CAPACITY };
+        CacheClock<TestPage, testPageId_t> clock { CAPACITY };
+        Cache2Q<TestPage, testPageId_t> twoQ { CAPACITY };
+        CacheClockPro<TestPage, testPageId_t> clockPro { CAPACITY };
+
+        size_t clockHitsNum = countHits (clock, ids.data (), ids.size ());
+
+        std::cout << "Testing CLOCK vs CLOCK model on " << name << " trace" << std::endl;
+        printTestResult (countClockModelHits (ids.data (), ids.size (), CAPACITY), clockHitsNum);
+
+        std::cout << "Testing CLOCK vs LRU on " << name << " trace" << std::endl;
+        printCloseHitsResult (countHits (lru, ids.data (), ids.size ()), clockHitsNum, LRU_TOLERANCE);
+
+        // CLOCK-Pro is scan resistant like 2Q, but it is a different policy.
+        std::cout << "Testing CLOCK-Pro vs 2Q on " << name << " trace" << std::endl;
+        printMinHitsResult (countHits (twoQ, ids.data (), ids.size ()), countHits (clockPro, ids.data (), ids.size ()));
+    }
+}
+
+void testAdaptive2Q( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << filename <<std::endl;
+        return;
+    }
+    TestTrace trace = readTrace (in);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    std::cout << "Testing adaptive 2Q vs 2Q with input file " << '\"' << filename << '\"' << std::endl;
+
+    // Cache2Q ALout is unbounded for capacity < 2 (as in list based version), adaptive one is not.
+    if (trace.cacheSize_ < 2)
+    {
+        std::cout << "Skipped: capacity " << trace.cacheSize_ << " < 2" << std::endl;
+        return;
+    }
+
+    Cache2Q<TestPage, testPageId_t> twoQ { trace.cacheSize_ };
+    CacheAdaptive2Q<TestPage, testPageId_t> adaptive2Q { trace.cacheSize_ };
+
+    printMinHitsResult (countHits (twoQ, ids, idsNum), countHits (adaptive2Q, ids, idsNum));
+}
+
+void testBelady( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << filename <<std::endl;
+        return;
+    }
+    TestTrace trace = readTrace (in);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    CacheLRU<TestPage, testPageId_t> lru { trace.cacheSize_ };
+    Cache2Q<TestPage, testPageId_t> twoQ { trace.cacheSize_ };
+
+    std::cout << "Testing OPT vs LRU & 2Q with input file " << '\"' << filename << '\"' << std::endl;
+    printOptResults (ids, idsNum, trace.cacheSize_, countHits (lru, ids, idsNum), countHits (twoQ, ids, idsNum));
+}
+
+void testBeladyKnownHits()
+{
+    static constexpr size_t CAPACITY = 3;
+    // Belady's example: OPT misses 7 times, LRU misses 10 times.
+    static const testPageId_t IDS[] = {1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5};
+    static constexpr size_t IDS_NUM = sizeof (IDS) / sizeof (IDS[0]);
+
+    std::cout << "Testing OPT & LRU on Belady's example" << std::endl;
 
-    caches::Cache2Q<TestPage, testPageId_t> cache { cacheSize };
+    CacheBelady<TestPage, testPageId_t> opt { CAPACITY, IDS, IDS_NUM };
+    printTestResult (5, countHits (opt, IDS, IDS_NUM));
+
+    CacheLRU<TestPage, testPageId_t> lru { CAPACITY };
+    printTestResult (2, countHits (lru, IDS, IDS_NUM));
+
+    // Each id is requested again only after all other ones, so OPT keeps
+    // the first CAPACITY ids & bypasses others: one hit per kept id per round.
+    std::vector<testPageId_t> loopIds {};
+    for (size_t round = 0; round < 4; ++round)
+        for (testPageId_t id = 0; id < 10; ++id)
+            loopIds.push_back (id);
+
+    CacheBelady<TestPage, testPageId_t> loopOpt { CAPACITY, loopIds.data (), loopIds.size () };
+    printTestResult (3 * CAPACITY, countHits (loopOpt, loopIds.data (), loopIds.size ()));
+}
+
+void testAdaptiveSplit()
+{
+    static constexpr size_t CAPACITY = 100;
+    static constexpr size_t BLOCKS_NUM = 200;
+    // Bigger than initial ALin, so second block read hits ALout.
+    static constexpr testPageId_t BLOCK_SIZE = 40;
+    static constexpr size_t LOOPS_NUM = 200;
+    // Bigger than AM after scan, so hot ids are evicted to AM ghosts.
+    static constexpr testPageId_t HOT_SIZE = 60;
+
+    using Stats = CacheAdaptive2Q<TestPage, testPageId_t>::Stats;
+
+    std::vector<testPageId_t> scanIds {};
+    for (size_t block = 0; block < BLOCKS_NUM; ++block)
+        for (size_t read = 0; read < 2; ++read)
+            for (testPageId_t id = 0; id < BLOCK_SIZE; ++id)
+                scanIds.push_back (HOT_SIZE + block * BLOCK_SIZE + id);
+
+    std::vector<testPageId_t> reuseIds {};
+    for (size_t loop = 0; loop < LOOPS_NUM; ++loop)
+        for (testPageId_t id = 0; id < HOT_SIZE; ++id)
+            reuseIds.push_back (id);
+
+    CacheAdaptive2Q<TestPage, testPageId_t> cache { CAPACITY };
+    Stats initStats = cache.getStats ();
+    size_t splitCapacity = initStats.amCapacity_ + initStats.alinCapacity_;
+
+    auto isConsistent = [splitCapacity]( const Stats& stats )
+    {
+        return stats.amCapacity_ + stats.alinCapacity_ == splitCapacity &&
+               stats.amCapacity_ > 0 && stats.alinCapacity_ > 0 &&
+               stats.amSize_ <= stats.amCapacity_ &&
+               stats.aloutSize_ <= stats.aloutCapacity_ &&
+               stats.amSize_ + stats.alinSize_ + stats.aloutSize_ <= splitCapacity + stats.aloutCapacity_ &&
+               stats.amGhostsSize_ <= splitCapacity;
+    };
+
+    size_t consistentNum = 0;
     TestPage::resetMissNum ();
+    for (const std::vector<testPageId_t>& ids : {scanIds, reuseIds})
+        for (testPageId_t id : ids)
+        {
+            cache.getElem (id);
+            consistentNum += isConsistent (cache.getStats ());
+        }
+    size_t hitsNum = scanIds.size () + reuseIds.size () - TestPage::getMissNum ();
+
+    std::cout << "Testing adaptive 2Q stats consistency" << std::endl;
+    printTestResult (scanIds.size () + reuseIds.size (), consistentNum);
+    Stats stats = cache.getStats ();
+    // ALout hits are hits, AM ghosts hits are misses.
+    printMinHitsResult (stats.aloutHitsNum_, hitsNum);
+    printMinHitsResult (stats.amGhostHitsNum_, TestPage::getMissNum ());
+
+    CacheAdaptive2Q<TestPage, testPageId_t> splitCache { CAPACITY };
+    countHits (splitCache, scanIds.data (), scanIds.size ());
+    Stats scanStats = splitCache.getStats ();
+    countHits (splitCache, reuseIds.data (), reuseIds.size ());
+    Stats reuseStats = splitCache.getStats ();
+
+    std::cout << "Testing adaptive 2Q ALin growth on scan" << std::endl;
+    printMinHitsResult (initStats.alinCapacity_ + 1, scanStats.alinCapacity_);
+
+    std::cout << "Testing adaptive 2Q AM growth on reuse after scan" << std::endl;
+    printMinHitsResult (scanStats.amCapacity_ + 1, reuseStats.amCapacity_);
+}
+
+void testTtl()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 5000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+    static constexpr tick_t TTL = 3000;
+    // Each JUMP_PERIOD requests time jumps by growing power of 4.
+    static constexpr size_t JUMP_PERIOD = 5000;
+    // Each ADD_PERIOD request is addElem with own ttl, some beyond wheel horizon.
+    static constexpr size_t ADD_PERIOD = 7;
+    static constexpr tick_t FAR_TTL = tick_t {1} << 26;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    CacheTtlLRU<TestPage, testPageId_t> cache {CAPACITY, TTL};
+    // Elements with deadlines from the most to the least recently used.
+    std::list<std::pair<testPageId_t, tick_t>> model {};
+
+    size_t expectedHitsNum = 0;
+    size_t hitsNum = 0;
+    tick_t now = 0;
+
+    for (size_t i = 0; i < ids.size (); ++i)
+    {
+        testPageId_t id = ids[i];
+        now += i % JUMP_PERIOD == 0 ? tick_t {1} << (2 * (i / JUMP_PERIOD)) : 1;
+        cache.advance (now);
+
+        model.remove_if ([now]( const auto& entry ) { return entry.second <= now; });
+        auto modelIt = std::find_if (model.begin (), model.end (), [id]( const auto& entry )
+            { return entry.first == id; });
+
+        if (i % ADD_PERIOD == 0)
+        {
+            tick_t ttl = id % 3 == 0 ? FAR_TTL + id : 1 + id % (2 * TTL);
+
+            if (modelIt != model.end ())
+                model.erase (modelIt);
+            else if (model.size () == CAPACITY)
+                model.pop_back ();
+            model.emplace_front (id, now + ttl);
+
+            cache.addElem ({TestPage {id}, id}, ttl);
+            continue;
+        }
+
+        if (modelIt != model.end ())
+        {
+            ++expectedHitsNum;
+            model.splice (model.begin (), model, modelIt);
+        }
+        else
+        {
+            if (model.size () == CAPACITY)
+                model.pop_back ();
+            model.emplace_front (id, now + TTL);
+        }
+
+        hitsNum += cache.isCached (id);
+        cache.getElem (id);
+    }
+
+    std::cout << "Testing ttl cache on Zipf trace" << std::endl;
+    printTestResult (expectedHitsNum, hitsNum);
+}
+
+void testTieredCache()
+{
+    static constexpr size_t REQUESTS_NUM = 50000;
+    static constexpr size_t KEYS_NUM = 5000;
+    static constexpr size_t MEMORY_CAPACITY = 500;
+    static constexpr double SKEW = 0.8;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+    std::vector<testPageId_t> uniqueIds = ids;
+    std::sort (uniqueIds.begin (), uniqueIds.end ());
+    uniqueIds.erase (std::unique (uniqueIds.begin (), uniqueIds.end ()), uniqueIds.end ());
+
+    std::string diskFilename = (std::filesystem::temp_directory_path () / "cache-test-tier.log").string ();
+
+    std::cout << "Testing two tier cache on Zipf trace" << std::endl;
+
+    size_t hitsNum = 0;
+    {
+        // Each request can spill one element at most, so log never wraps around.
+        TieredCache2Q<IdPage, testPageId_t> cache {MEMORY_CAPACITY, diskFilename.c_str (), REQUESTS_NUM};
+        if (!cache.isValid ())
+        {
+            std::cout << "Cannot open file " << diskFilename << std::endl;
+            return;
+        }
+
+        for (testPageId_t id : ids)
+            if (cache.getElem (id).id_ != id)
+                break;
+
+        TieredCache2Q<IdPage, testPageId_t>::Stats stats = cache.getStats ();
+        hitsNum = stats.memoryHitsNum_ + stats.diskHitsNum_;
+    }
+    std::filesystem::remove (diskFilename);
+
+    printTestResult (ids.size () - uniqueIds.size (), hitsNum);
+}
+
+void testPolicyCache()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    CacheLRU<TestPage, testPageId_t> lru { CAPACITY };
+    CacheClock<TestPage, testPageId_t> clock { CAPACITY };
+    Cache2Q<TestPage, testPageId_t> twoQ { CAPACITY };
+    size_t lruHitsNum = countHits (lru, ids.data (), ids.size ());
+    size_t clockHitsNum = countHits (clock, ids.data (), ids.size ());
+    size_t hits2QNum = countHits (twoQ, ids.data (), ids.size ());
+
+    PolicyCache<TestPage, testPageId_t> defaultLru { CAPACITY };
+    PolicyCache<TestPage, testPageId_t, LruEviction, MapIndex<testPageId_t>, NodeValues<TestPage>, Locked>
+        lockedLru { CAPACITY };
+    PolicyCache<TestPage, testPageId_t, ClockEviction, MapIndex<testPageId_t>, NodeValues<TestPage>> nodeClock
+        { CAPACITY };
+    PolicyCache<TestPage, testPageId_t, TwoQEviction, MapIndex<testPageId_t>, NodeValues<TestPage>, Locked>
+        locked2Q { CAPACITY };
+
+    std::cout << "Testing policy cache with LRU eviction vs LRU on Zipf trace" << std::endl;
+    printTestResult (lruHitsNum, countHits (defaultLru, ids.data (), ids.size ()));
+    printTestResult (lruHitsNum, countHits (lockedLru, ids.data (), ids.size ()));
+
+    std::cout << "Testing policy cache with CLOCK eviction vs CLOCK on Zipf trace" << std::endl;
+    printTestResult (clockHitsNum, countHits (nodeClock, ids.data (), ids.size ()));
+
+    std::cout << "Testing policy cache with 2Q eviction vs 2Q on Zipf trace" << std::endl;
+    printTestResult (hits2QNum, countHits (locked2Q, ids.data (), ids.size ()));
+}
+
+void testConcurrentCache()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+    static constexpr size_t THREADS_NUM = 4;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    PolicyCache<TestPage, testPageId_t, FifoEviction> fifo { CAPACITY };
+    size_t fifoHitsNum = countHits (fifo, ids.data (), ids.size ());
+
+    size_t hitsNum = 0;
+    {
+        ConcurrentCacheLRU<TestPage, testPageId_t> cache { CAPACITY };
+        auto reader = cache.getReader ();
+        hitsNum = countHits (*reader, ids.data (), ids.size ());
+    }
+
+    std::cout << "Testing concurrent LRU vs FIFO on Zipf trace" << std::endl;
+    printMinHitsResult (fifoHitsNum, hitsNum);
+
+    ConcurrentCacheLRU<IdPage, testPageId_t> cache { CAPACITY };
+    std::atomic<size_t> rightNum {0};
+    std::vector<std::thread> threads {};
+
+    for (size_t threadId = 0; threadId < THREADS_NUM; ++threadId)
+        threads.emplace_back ([&cache, &rightNum, threadId]
+        {
+            auto reader = cache.getReader ();
+            size_t threadRightNum = 0;
+
+            for (testPageId_t id : genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, threadId))
+                threadRightNum += reader->getElem (id).id_ == id;
+
+            rightNum += threadRightNum;
+        });
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    std::cout << "Testing concurrent LRU elements in " << THREADS_NUM << " threads" << std::endl;
+    printTestResult (THREADS_NUM * REQUESTS_NUM, rightNum);
+}
+
+void testBatchLookup()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+    // Several prefetch chunks, but too small to evict its own misses.
+    static constexpr size_t BATCH_SIZE = 4 * PREFETCH_CHUNK;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    {
+        CacheLRU<TestPage, testPageId_t> lru { CAPACITY };
+        CacheLRU<TestPage, testPageId_t> batchLru { CAPACITY };
+
+        std::cout << "Testing LRU batches of one vs getElem loop" << std::endl;
+        printTestResult (countHits (lru, ids.data (), ids.size ()), countBatchHits (batchLru, ids, 1));
+    }
+    {
+        CacheLRU<TestPage, testPageId_t> lru { CAPACITY };
+        CacheLRU<TestPage, testPageId_t> batchLru { CAPACITY };
+
+        size_t modelHitsNum = countBatchModelHits (ids, BATCH_SIZE,
+            [&lru]( testPageId_t id )
+            {
+                if (!lru.isCached (id))
+                    return false;
+
+                lru.getElem (id);
+                return true;
+            },
+            [&lru]( testPageId_t id ) { lru.addElem ({TestPage {id}, id}); });
+
+        std::cout << "Testing LRU batches vs getElem loop" << std::endl;
+        printTestResult (modelHitsNum, countBatchHits (batchLru, ids, BATCH_SIZE));
+    }
+    {
+        Cache2Q<TestPage, testPageId_t> twoQ { CAPACITY };
+        Cache2Q<TestPage, testPageId_t> batch2Q { CAPACITY };
+
+        std::cout << "Testing 2Q batches of one vs getElem loop" << std::endl;
+        printTestResult (countHits (twoQ, ids.data (), ids.size ()), countBatchHits (batch2Q, ids, 1));
+    }
+    {
+        Cache2Q<TestPage, testPageId_t> twoQ { CAPACITY };
+        Cache2Q<TestPage, testPageId_t> batch2Q { CAPACITY };
+
+        size_t modelHitsNum = countBatchModelHits (ids, BATCH_SIZE,
+            [&twoQ]( testPageId_t id ) { return twoQ.findElem (id) != nullptr; },
+            [&twoQ]( testPageId_t id ) { twoQ.addLoaded (id, TestPage {id}); });
+
+        std::cout << "Testing 2Q batches vs getElem loop" << std::endl;
+        printTestResult (modelHitsNum, countBatchHits (batch2Q, ids, BATCH_SIZE));
+    }
+
+    CacheLRU<IdPage, testPageId_t> lru { CAPACITY };
+    Cache2Q<IdPage, testPageId_t> twoQ { CAPACITY };
+
+    std::cout << "Testing LRU & 2Q batches elements" << std::endl;
+    printTestResult (REQUESTS_NUM, countBatchRightElems (lru, ids, BATCH_SIZE));
+    printTestResult (REQUESTS_NUM, countBatchRightElems (twoQ, ids, BATCH_SIZE));
+}
+
+void testSizedCache()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 5000;
+    static constexpr double SKEW = 0.8;
+    static constexpr size_t PAGE_SIZE = SizedTestPage::PAGE_SIZE_;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+    SizedTestPage::resetParams ();
+
+    auto countSizedHits = [&ids]( auto& cache )
+    {
+        SizedTestPage::resetMissNum ();
+        for (testPageId_t id : ids)
+            cache.getElem (id);
+
+        return ids.size () - SizedTestPage::getMissNum ();
+    };
+
+    // Small capacities check minimum lists capacities, others check quotas rounding.
+    // Cache2Q ALout is unbounded for capacity < 2, so it is not compared.
+    for (size_t capacity : {2, 3, 10, 13, 50, 1000})
+    {
+        CacheLRU<TestPage, testPageId_t> lru { capacity };
+        SizedCacheLRU<SizedTestPage, testPageId_t> sizedLru { capacity * PAGE_SIZE };
+
+        std::cout << "Testing sized LRU vs LRU with capacity " << capacity << std::endl;
+        printTestResult (countHits (lru, ids.data (), ids.size ()), countSizedHits (sizedLru));
+
+        Cache2Q<TestPage, testPageId_t> twoQ { capacity };
+        SizedCache2Q<SizedTestPage, testPageId_t> sized2Q { capacity * PAGE_SIZE, PAGE_SIZE };
+
+        std::cout << "Testing sized 2Q vs 2Q with capacity " << capacity << std::endl;
+        printTestResult (countHits (twoQ, ids.data (), ids.size ()), countSizedHits (sized2Q));
+    }
+}
+
+void testMetrics()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    {
+        CacheLRU<TestPage, testPageId_t> cache { CAPACITY };
+        printMetricsResult ("LRU", cache, ids, CAPACITY);
+    }
+    {
+        Cache2Q<TestPage, testPageId_t> cache { CAPACITY };
+        printMetricsResult ("2Q", cache, ids, CAPACITY);
+        printTestResult (cache.getMetrics ()[CacheMetrics::ALOUT_HITS], cache.getMetrics ()[CacheMetrics::PROMOTIONS]);
+    }
+    {
+        CacheAdaptive2Q<TestPage, testPageId_t> cache { CAPACITY };
+        printMetricsResult ("adaptive 2Q", cache, ids, CAPACITY);
+        printTestResult (cache.getStats ().aloutHitsNum_, cache.getMetrics ()[CacheMetrics::ALOUT_HITS]);
+    }
+    {
+        CacheClock<TestPage, testPageId_t> cache { CAPACITY };
+        printMetricsResult ("CLOCK", cache, ids, CAPACITY);
+    }
+    {
+        CacheClockPro<TestPage, testPageId_t> cache { CAPACITY };
+        printMetricsResult ("CLOCK-Pro", cache, ids, CAPACITY);
+    }
+
+    // 3 hits of 4 requests.
+    CacheMetrics::Snapshot snapshot {};
+    snapshot[CacheMetrics::AM_HITS] = 2;
+    snapshot[CacheMetrics::ALIN_HITS] = 1;
+    snapshot[CacheMetrics::MISSES] = 1;
+    snapshot[CacheMetrics::LOADS] = 1;
+    snapshot[CacheMetrics::LOADS_TIME_NS] = 500;
+    snapshot[CacheMetrics::MAX_LOAD_TIME_NS] = 500;
 
+    static const std::string JSON_HEAD = "{\"cache\": \"test\", \"time_ms\": ";
+    static const std::string JSON_TAIL =
+        ", \"hits\": 0, \"am_hits\": 2, \"alin_hits\": 1, \"alout_hits\": 0, \"misses\": 1,"
+        " \"evictions\": 0, \"promotions\": 0, \"rejections\": 0, \"loads\": 1,"
+        " \"loads_time_ns\": 500, \"max_load_time_ns\": 500, \"hit_rate\": 0.75}\n";
+
+    // Time field changes from run to run.
+    auto isRightJson = []( const std::string& json )
+    {
+        return json.size () > JSON_HEAD.size () + JSON_TAIL.size () &&
+               json.compare (0, JSON_HEAD.size (), JSON_HEAD) == 0 &&
+               json.compare (json.size () - JSON_TAIL.size (), JSON_TAIL.size (), JSON_TAIL) == 0 &&
+               std::count (json.begin (), json.end (), '\n') == 1;
+    };
+
+    std::ostringstream out {};
+    printSnapshot (out, "test", snapshot);
+
+    std::cout << "Testing metrics json line" << std::endl;
+    printTestResult (1, isRightJson (out.str ()));
+
+    // Dumper period is too long, so the only line is printed in dtor.
+    std::ostringstream dumpOut {};
+    {
+        MetricsDumper dumper {[&snapshot] { return snapshot; }, dumpOut, "test", std::chrono::hours {1}};
+    }
+
+    std::cout << "Testing metrics dumper json line" << std::endl;
+    printTestResult (1, isRightJson (dumpOut.str ()));
+}
+
+void testShardedCache()
+{
+    static constexpr size_t REQUESTS_NUM = 100000;
+    static constexpr size_t KEYS_NUM = 10000;
+    static constexpr size_t CAPACITY = 1000;
+    static constexpr double SKEW = 0.8;
+    static constexpr size_t SHARDS_NUM = 4;
+    static constexpr size_t THREADS_NUM = 4;
+
+    std::vector<testPageId_t> ids = genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, 0);
+
+    ShardedCache2Q<TestPage, testPageId_t> sharded { CAPACITY, SHARDS_NUM };
+    size_t hitsNum = countHits (sharded, ids.data (), ids.size ());
+
+    // Capacity is divisible by shards number, so all shards are the same.
+    std::vector<Cache2Q<TestPage, testPageId_t>> shards {};
+    shards.reserve (SHARDS_NUM);
+    for (size_t i = 0; i < SHARDS_NUM; ++i)
+        shards.emplace_back (CAPACITY / SHARDS_NUM);
+
+    TestPage::resetMissNum ();
+    for (testPageId_t id : ids)
+        shards[sharded.getShardId (id)].getElem (id);
+    size_t shardsHitsNum = REQUESTS_NUM - TestPage::getMissNum ();
+
+    std::cout << "Testing sharded 2Q vs 2Q per shard on Zipf trace" << std::endl;
+    printTestResult (shardsHitsNum, hitsNum);
+
+    ShardedCache2Q<IdPage, testPageId_t> cache { CAPACITY, SHARDS_NUM };
+    std::atomic<size_t> rightNum {0};
+    std::vector<std::thread> threads {};
+
+    for (size_t threadId = 0; threadId < THREADS_NUM; ++threadId)
+        threads.emplace_back ([&cache, &rightNum, threadId]
+        {
+            size_t threadRightNum = 0;
+
+            for (testPageId_t id : genZipfTrace (REQUESTS_NUM, KEYS_NUM, SKEW, threadId))
+                threadRightNum += cache.getElem (id).id_ == id;
+
+            rightNum += threadRightNum;
+        });
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    std::cout << "Testing sharded 2Q elements in " << THREADS_NUM << " threads" << std::endl;
+    printTestResult (THREADS_NUM * REQUESTS_NUM, rightNum);
+}
+
+void testAsyncLoader()
+{
+    static constexpr size_t THREADS_NUM = 8;
+    static constexpr testPageId_t ID = 42;
+
+    std::atomic<size_t> constructedNum {0};
+    std::atomic<size_t> requestedNum {0};
+
+    // Backend waits for all requests, so they all miss while load is in flight.
+    AsyncLoader<IdPage, testPageId_t> loader {[&constructedNum, &requestedNum]( testPageId_t id )
+    {
+        while (requestedNum != THREADS_NUM)
+            std::this_thread::yield ();
+
+        ++constructedNum;
+        return IdPage {id};
+    }, THREADS_NUM};
+
+    std::atomic<size_t> rightNum {0};
+    std::vector<std::thread> threads {};
+
+    for (size_t threadId = 0; threadId < THREADS_NUM; ++threadId)
+        threads.emplace_back ([&loader, &requestedNum, &rightNum]
+        {
+            std::shared_future<IdPage> future = loader.load (ID);
+            ++requestedNum;
+
+            rightNum += future.get ().id_ == ID;
+        });
+
+    for (std::thread& thread : threads)
+        thread.join ();
+
+    std::cout << "Testing async loader constructions for one id in " << THREADS_NUM << " threads" << std::endl;
+    printTestResult (1, constructedNum);
+    printTestResult (1, loader.getBackendCallsNum ());
+    printTestResult (THREADS_NUM - 1, loader.getCoalescedNum ());
+
+    std::cout << "Testing async loader elements for one id in " << THREADS_NUM << " threads" << std::endl;
+    printTestResult (THREADS_NUM, rightNum);
+}
+
+void testSnapshot( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << filename <<std::endl;
+        return;
+    }
+    TestTrace trace = readTrace (in);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    std::filesystem::path tmpDir = std::filesystem::temp_directory_path ();
+    std::string elemsFilename = (tmpDir / "cache-test-snapshot-elems.bin").string ();
+    std::string idsFilename = (tmpDir / "cache-test-snapshot-ids.bin").string ();
+
+    Cache2Q<TestPage, testPageId_t> warm { trace.cacheSize_ };
+    countHits (warm, ids, idsNum);
+
+    Cache2Q<TestPage, testPageId_t> restoredElems { trace.cacheSize_ };
+    Cache2Q<TestPage, testPageId_t> restoredIds { trace.cacheSize_ };
+    bool isRestored = warm.saveSnapshot (elemsFilename.c_str (), true) &&
+                      warm.saveSnapshot (idsFilename.c_str ()) &&
+                      restoredElems.loadSnapshot (elemsFilename.c_str ()) &&
+                      restoredIds.loadSnapshot (idsFilename.c_str ());
+    std::filesystem::remove (elemsFilename);
+    std::filesystem::remove (idsFilename);
+
+    std::cout << "Testing snapshot with input file " << '\"' << filename << '\"' << std::endl;
+    if (!isRestored)
+    {
+        std::cout << "Cannot save or load snapshot" << std::endl;
+        return;
+    }
+
+    size_t warmHitsNum = countHits (warm, ids, idsNum);
+    printTestResult (warmHitsNum, countHits (restoredElems, ids, idsNum));
+    printTestResult (warmHitsNum, countHits (restoredIds, ids, idsNum));
+}
+
+void testStackDistances( const char * filename )
+{
+    assert (filename != nullptr);
+
+    std::ifstream in(filename);
+    if (!in.is_open ())
+    {
+        std::cout << "Cannot open file " << filename <<std::endl;
+        return;
+    }
+    TestTrace trace = readTrace (in);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    StackDistances distances {ids, idsNum, trace.cacheSize_};
+
+    std::cout << "Testing stack distances with input file " << '\"' << filename << '\"' << std::endl;
+    for (size_t capacity = 1; capacity <= trace.cacheSize_; ++capacity)
+    {
+        CacheLRU<TestPage, testPageId_t> lru { capacity };
+        size_t hitsNum = countHits (lru, ids, idsNum);
+
+        // Only failures & the last capacity are printed.
+        if (hitsNum != distances.getLruHits (capacity) || capacity == trace.cacheSize_)
+            printTestResult (hitsNum, distances.getLruHits (capacity));
+    }
+}
+
+void testGeneratedTrace( const char * filename )
+{
+    assert (filename != nullptr);
+
+    MappedTrace trace {filename};
+    if (!trace.isValid ())
+    {
+        std::cout << "Cannot map binary trace " << filename << std::endl;
+        return;
+    }
+    const testPageId_t * ids = trace.ids ();
+    size_t idsNum = trace.size ();
+    size_t capacity = trace.getCacheSize ();
+
+    std::cout << "Testing with generated trace " << '\"' << filename << '\"';
+    std::cout << " (" << idsNum << " requests)" << std::endl;
+
+    CacheLRU<TestPage, testPageId_t> lru { capacity };
+    size_t lruHitsNum = countHits (lru, ids, idsNum);
+    StackDistances distances {ids, idsNum, capacity};
+    printTestResult (lruHitsNum, distances.getLruHits (capacity));
+
+    CacheClock<TestPage, testPageId_t> clock { capacity };
+    printTestResult (countClockModelHits (ids, idsNum, capacity), countHits (clock, ids, idsNum));
+
+    Cache2Q<TestPage, testPageId_t> cache2Q { capacity };
+    size_t hits2QNum = countHits (cache2Q, ids, idsNum);
+    printTestResult (sample2QHits (ids, idsNum, {capacity}, 1)[0], hits2QNum);
+
+    CacheAdaptive2Q<TestPage, testPageId_t> adaptive2Q { capacity };
+    printMinHitsResult (hits2QNum, countHits (adaptive2Q, ids, idsNum));
+
+    printOptResults (ids, idsNum, capacity, lruHitsNum, hits2QNum);
+}
+
+size_t replayBinTrace( const char * filename )
+{
+    assert (filename != nullptr);
+
+    MappedTrace trace {filename};
+    if (!trace.isValid ())
+    {
+        std::cout << "Cannot map binary trace " << filename << std::endl;
+        return 0;
+    }
+
+    Cache2Q<TestPage, testPageId_t> cache { trace.getCacheSize () };
+
+    return countHits (cache, trace.ids (), trace.size ());
+}
+
+TestTrace readTrace( std::istream& in )
+{
+    TestTrace trace {};
+    size_t inputSize = 0;
+
+    in >> trace.cacheSize_ >> inputSize;
+
+    trace.ids_.resize (inputSize);
     for (size_t i = 0; i < inputSize; ++i)
-        cache.getElem (pIds [i]);
+        in >> trace.ids_[i];
+
+    return trace;
+}
+
+size_t test2QEfficiency()
+{
+    TestTrace trace = readTrace (std::cin);
+
+    caches::Cache2Q<TestPage, testPageId_t> cache { trace.cacheSize_ };
+
+    return countHits (cache, trace.ids_.data (), trace.ids_.size ());
+}
+
+void cmpEfficiency()
+{
+    TestTrace trace = readTrace (std::cin);
+    const testPageId_t * ids = trace.ids_.data ();
+    size_t idsNum = trace.ids_.size ();
+
+    caches::CacheBelady<TestPage, testPageId_t> opt { trace.cacheSize_, ids, idsNum };
+    caches::CacheLRU<TestPage, testPageId_t> lru { trace.cacheSize_ };
+    caches::Cache2Q<TestPage, testPageId_t> twoQ { trace.cacheSize_ };
+
+    std::cout << "Requests: " << idsNum << std::endl;
+    std::cout << "OPT hits: " << countHits (opt, ids, idsNum) << std::endl;
+    std::cout << "LRU hits: " << countHits (lru, ids, idsNum) << std::endl;
+    std::cout << "2Q  hits: " << countHits (twoQ, ids, idsNum) << std::endl;
+}
+
+void cmpSizedEfficiency()
+{
+    TestTrace trace = readTrace (std::cin);
+
+    size_t paramsNum = 0;
+    std::cin >> paramsNum;
+
+    SizedTestPage::resetParams ();
+    for (size_t i = 0; i < paramsNum; ++i)
+    {
+        testPageId_t id = 0;
+        size_t size = 0;
+        double cost = 0;
+
+        std::cin >> id >> size >> cost;
+        SizedTestPage::setParams (id, size, cost);
+    }
 
-    delete [] pIds;
+    caches::SizedCacheLRU<SizedTestPage, testPageId_t> lru { trace.cacheSize_ };
+    caches::SizedCache2Q<SizedTestPage, testPageId_t> twoQ { trace.cacheSize_, SizedTestPage::PAGE_SIZE_ };
 
-    return inputSize - TestPage::getMissNum ();
+    std::cout << "Requests: " << trace.ids_.size () << std::endl;
+    printSizedHits ("LRU", lru, trace.ids_);
+    printSizedHits ("2Q ", twoQ, trace.ids_);
 }
 
 } // namespace caches
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <cstring>
+
+#include "cache-trace.hh"
+
+namespace caches
+{
+
+bool convertTrace( const char * textFilename, const char * binFilename )
+{
+    assert (textFilename != nullptr && binFilename != nullptr);
+
+    std::ifstream in {textFilename};
+    std::ofstream out {binFilename, std::ios::binary};
+    if (!in.is_open () || !out.is_open ())
+        return false;
+
+    BinTraceHeader header {};
+    std::memcpy (header.magic_, BinTraceHeader::MAGIC, sizeof (header.magic_));
+    header.version_ = BinTraceHeader::VERSION;
+
+    if (!(in >> header.cacheSize_ >> header.idsNum_))
+        return false;
+
+    out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+
+    // Ids are written by chunks, so whole trace is never stored in memory.
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+    std::vector<testPageId_t> chunk {};
+    chunk.reserve (CHUNK_SIZE);
+
+    for (std::uint64_t i = 0; i < header.idsNum_; ++i)
+    {
+        testPageId_t id = 0;
+        if (!(in >> id))
+            return false;
+
+        chunk.push_back (id);
+        if (chunk.size () == CHUNK_SIZE || i + 1 == header.idsNum_)
+        {
+            out.write (reinterpret_cast<const char *> (chunk.data ()), chunk.size () * sizeof (testPageId_t));
+            chunk.clear ();
+        }
+    }
+
+    return out.good ();
+}
+
+bool writeTrace( const char * binFilename, size_t cacheSize, const testPageId_t * ids, size_t idsNum )
+{
+    assert (binFilename != nullptr && (ids != nullptr || idsNum == 0));
+
+    std::ofstream out {binFilename, std::ios::binary};
+    if (!out.is_open ())
+        return false;
+
+    BinTraceHeader header {};
+    std::memcpy (header.magic_, BinTraceHeader::MAGIC, sizeof (header.magic_));
+    header.version_ = BinTraceHeader::VERSION;
+    header.cacheSize_ = cacheSize;
+    header.idsNum_ = idsNum;
+
+    out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+    out.write (reinterpret_cast<const char *> (ids), idsNum * sizeof (testPageId_t));
+
+    return out.good ();
+}
+
+MappedTrace::MappedTrace( const char * filename ) :
+    file_ (filename)
+{
+    if (file_.size () < sizeof (BinTraceHeader))
+        return;
+
+    const BinTraceHeader * header = reinterpret_cast<const BinTraceHeader *> (file_.data ());
+    if (std::memcmp (header->magic_, BinTraceHeader::MAGIC, sizeof (header->magic_)) ||
+        header->version_ != BinTraceHeader::VERSION ||
+        file_.size () - sizeof (BinTraceHeader) != header->idsNum_ * sizeof (testPageId_t))
+        return;
+
+    header_ = header;
+    ids_ = reinterpret_cast<const testPageId_t *> (header + 1);
+}
+
+bool MappedTrace::isValid() const
+{
+    return header_ != nullptr;
+}
+
+size_t MappedTrace::getCacheSize() const
+{
+    return isValid () ? header_->cacheSize_ : 0;
+}
+
+size_t MappedTrace::size() const
+{
+    return isValid () ? header_->idsNum_ : 0;
+}
+
+const testPageId_t * MappedTrace::ids() const
+{
+    return ids_;
+}
+
+} // namespace caches
@@ -0,0 +1,81 @@
+#include <vector>
+
+#ifndef GEOM3D_BVH_HH_INCL
+#define GEOM3D_BVH_HH_INCL
+
+#include "geom3D-pool.hh"
+#include "geom3D-soup.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+/* Bounding volume hierarchy of triangles bounding boxes.
+
+   Tree is built top down: each node is split by the surface area heuristic
+   (SAH) over binned boxes centers, so clustered triangles get tight nodes
+   and big triangles don't get copied to many nodes as octree borders do.
+   Triangles are stored in TriangleSoup in leafs order, each node covers
+   a range of it. cross () descends pairs of nodes with crossed boxes
+   (with BOX_PRECISION, as TriangleSoup::mayCross does) and checks pairs of
+   leafs triangles on the soup, so results are the same as brute force ones.
+*/
+class BVHTrsGroup final
+{
+    struct Node final
+    {
+        Coordinates lower_{};
+        Coordinates upper_{};
+        // Soup triangles range.
+        size_t begin_ = 0;
+        size_t end_ = 0;
+        // Children nodes ids, 0 for leafs (root can't be a child).
+        size_t left_ = 0;
+        size_t right_ = 0;
+
+        bool isLeaf() const noexcept
+        {
+            return left_ == 0;
+        }
+    };
+
+    // Pair of nodes to be checked.
+    using NodesPair = std::pair<size_t, size_t>;
+
+    // nodes_[0] is root, it is absent for empty group.
+    std::vector<Node> nodes_{};
+    TriangleSoup soup_{};
+
+  public:
+    // Leafs contain at most MAX_LEAF_SIZE triangles.
+    static constexpr size_t MAX_LEAF_SIZE = 16;
+
+    explicit BVHTrsGroup(const IndexedTrsGroup &);
+
+    size_t nodesNum() const noexcept
+    {
+        return nodes_.size();
+    }
+
+    TrsIndexes cross() const;
+    // The same, but pairs of subtrees are crossed in parallel by pool workers.
+    TrsIndexes cross(ThreadPool &) const;
+
+  private:
+    bool boxesCross(const Node &ft, const Node &sd) const;
+    // Descends from given pair, pairs of leafs are crossed.
+    void crossNodes(NodesPair startPair, std::vector<bool> &crossMask) const;
+    void crossLeafs(const Node &ft, const Node &sd, std::vector<bool> &crossMask) const;
+    // Crosses pairs of ft triangles with sd triangles of greater indexes.
+    void crossLeafsFrom(const Node &ft, const Node &sd, std::vector<bool> &crossMask) const;
+    // Splits pair to children pairs, returns false for pairs of leafs.
+    bool splitPair(NodesPair, std::vector<NodesPair> &pairs) const;
+
+  public:
+    // Testing stuff - implemented in tests files.
+    static bool testTree(const IndexedTrsGroup &);
+};
+
+} // namespace geom3D
+
+#endif // #ifndef GEOM3D_BVH_HH_INCL
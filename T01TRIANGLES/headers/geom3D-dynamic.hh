@@ -0,0 +1,117 @@
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#ifndef GEOM3D_DYNAMIC_HH_INCL
+#define GEOM3D_DYNAMIC_HH_INCL
+
+#include "geom3D-soup.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+/* Triangles group with insert, remove & move of single triangles.
+
+   Triangles bounding boxes are kept in dynamic AABB tree: constructor
+   builds it top down, then leafs are inserted next to the sibling with
+   the least boxes area growth and the tree is rebalanced by rotations
+   on the way up. Each triangle keeps indexes of triangles it crosses.
+   Update re-tests only changed triangle against triangles with crossed
+   boxes (with BOX_PRECISION, as TriangleSoup::mayCross does), so its
+   cost doesn't depend on group size.
+
+   Pairs are checked in indexes order, so cross () is the same as brute
+   force one for group ordered by indexes.
+*/
+class DynamicTrsGroup final
+{
+    static constexpr size_t NULL_NODE = SIZE_MAX;
+
+    struct Node final
+    {
+        Coordinates lower_{};
+        Coordinates upper_{};
+        size_t parent_ = NULL_NODE;
+        // Children nodes ids, NULL_NODE for leafs.
+        size_t left_ = NULL_NODE;
+        size_t right_ = NULL_NODE;
+        // Subtree height, 0 for leafs.
+        size_t height_ = 0;
+        // Triangle index for leafs.
+        size_t index_ = 0;
+
+        bool isLeaf() const noexcept
+        {
+            return left_ == NULL_NODE;
+        }
+    };
+
+    struct Entry final
+    {
+        Triangle tr_{};
+        size_t leafId_ = NULL_NODE;
+        // Indexes of crossed triangles.
+        std::vector<size_t> crossed_{};
+    };
+
+    std::vector<Node> nodes_{};
+    std::vector<size_t> freeNodesIds_{};
+    size_t rootId_ = NULL_NODE;
+
+    std::unordered_map<size_t, Entry> entries_{};
+    // Indexes of triangles crossed with any other one.
+    std::set<size_t> crossedIndexes_{};
+
+  public:
+    DynamicTrsGroup() = default;
+    explicit DynamicTrsGroup(const IndexedTrsGroup &);
+
+    size_t size() const noexcept
+    {
+        return entries_.size();
+    }
+
+    bool contains(size_t index) const
+    {
+        return entries_.find(index) != entries_.end();
+    }
+
+    // Returns false if index is already used.
+    bool insert(const Triangle &, size_t index);
+    // Returns false if there is no such index.
+    bool remove(size_t index);
+    bool move(size_t index, const Triangle &);
+
+    // Indexes in ascending order.
+    TrsIndexes cross() const;
+
+  private:
+    void setLeafBox(const Entry &);
+    // Finds triangles crossed with entry one.
+    void link(size_t index, Entry &);
+    void linkIfCrossed(size_t index, Entry &, size_t otherIndex);
+    void unlink(size_t index, Entry &);
+
+    size_t allocNode();
+    void freeNode(size_t nodeId);
+    // Builds subtree of leafs, returns its root.
+    size_t build(std::vector<size_t>::iterator first, std::vector<size_t>::iterator last);
+    void insertLeaf(size_t leafId);
+    void removeLeaf(size_t leafId);
+    // Refits boxes & heights from node to root.
+    void fixUpwards(size_t nodeId);
+    // Rotates unbalanced subtree, returns its new root.
+    size_t balance(size_t nodeId);
+    void refit(size_t nodeId);
+    // Indexes of triangles with boxes crossed with given one.
+    void query(const Node &box, std::vector<size_t> &indexes) const;
+
+  public:
+    // Testing stuff - implemented in tests files.
+    static bool testTree(const DynamicTrsGroup &);
+};
+
+} // namespace geom3D
+
+#endif // #ifndef GEOM3D_DYNAMIC_HH_INCL
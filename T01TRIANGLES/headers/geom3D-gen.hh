@@ -54,6 +54,48 @@ inline IndexedTrsGroup genSmallTrsGroup(size_t trNum)
     return gr;
 }
 
+// Kinds of generated scene triangles.
+struct SceneParams final
+{
+    // Small triangles scale: scale < 1 gives segments too short for valid Line.
+    fp_t scale = 1;
+    // Small triangles are scattered over space, so they are not crowded.
+    bool isScattered = false;
+    // Each 5th triangle is segment & each 7th one is point.
+    bool hasDegenerate = true;
+    // Each 100th triangle is huge. Not of genP () points: thin triangles
+    // of domain size fail Triangle::isConsistent.
+    bool hasHuge = false;
+};
+
+// Scene triangle of given index.
+inline Triangle genSceneTr(size_t i, const SceneParams &params = {})
+{
+    Vector shift = params.isScattered ? genVec() / 20 : Vector::zero();
+    auto genScaledP = [&params, &shift] { return Point{0, 0, 0} + genVec() * (SMALL_FACTOR * params.scale) + shift; };
+
+    Point A = genScaledP();
+    Point B = genScaledP();
+
+    Point O{0, 0, 0};
+    if (params.hasHuge && i % 100 == 0)
+        return Triangle{O + genVec() / 2, O + genVec() / 2, O + genVec() / 2};
+    if (params.hasDegenerate && i % 5 == 0)
+        return Triangle{A, B, A};
+    if (params.hasDegenerate && i % 7 == 0)
+        return Triangle{A, A, A};
+    return Triangle{A, B, genScaledP()};
+}
+
+inline IndexedTrsGroup genSceneTrsGroup(size_t trNum, const SceneParams &params = {})
+{
+    IndexedTrsGroup gr{};
+    for (size_t i = 0; i < trNum; ++i)
+        gr.push_back({genSceneTr(i, params), i});
+
+    return gr;
+}
+
 } // namespace geom3D
 
 #endif // #ifndef GEOM3D_TESTS_HH_INCL
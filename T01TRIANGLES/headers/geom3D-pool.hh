@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef GEOM3D_POOL_HH_INCL
+#define GEOM3D_POOL_HH_INCL
+
+namespace geom3D
+{
+
+/* Work stealing thread pool for independent tasks.
+
+   run () splits tasks ids into equal ranges, one per worker deque.
+   Workers pop tasks from own deque front and steal from other deques
+   back when own one is empty, so long tasks don't stall the whole run.
+   Calling thread is worker 0, pool of one thread runs tasks in place.
+*/
+class ThreadPool final
+{
+    // Tasks ids deque of one worker.
+    struct Worker final
+    {
+        std::mutex mutex_{};
+        std::deque<size_t> tasks_{};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_{};
+    std::vector<std::thread> threads_{};
+
+    // Run state: job_ is set before runId_ increment & is valid till all threads are done.
+    // Threads sleep on atomics waits between runs.
+    const std::function<void(size_t, size_t)> *job_ = nullptr;
+    std::atomic<size_t> runId_ = 0;
+    std::atomic<size_t> busyThreadsNum_ = 0;
+    std::atomic<bool> isStopped_ = false;
+
+  public:
+    // Pool of threadsNum workers (of hardware threads number for 0).
+    explicit ThreadPool(size_t threadsNum);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    size_t size() const noexcept
+    {
+        return workers_.size();
+    }
+
+    // Calls job (taskId, workerId) once for each taskId from [0, tasksNum)
+    // & returns when all calls are done. Job should not throw.
+    void run(size_t tasksNum, const std::function<void(size_t taskId, size_t workerId)> &job);
+
+  private:
+    void work(size_t workerId);
+    void runTasks(size_t workerId);
+    bool popTask(size_t workerId, size_t &taskId);
+};
+
+} // namespace geom3D
+
+#endif // #ifndef GEOM3D_POOL_HH_INCL
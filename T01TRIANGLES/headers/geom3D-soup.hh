@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#ifndef GEOM3D_SOUP_HH_INCL
+#define GEOM3D_SOUP_HH_INCL
+
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+// Coordinates precision used for bounding boxes comparsions.
+constexpr fp_t BOX_PRECISION = fpCmpW<>::CMP_PRECISION;
+
+// Packed triangle record: no vptrs, no padding segments,
+// only data needed for cheap crossing checks.
+struct PackedTriangle final
+{
+    // Points in Triangle::operator[] order.
+    std::array<Coordinates, TR_POINT_NUM> P_{};
+    // Plane, the same as Triangle::plane () one. Invalid for degenerate triangles.
+    Coordinates n_{};
+    fp_t D_ = nan;
+    // Bounding box.
+    Coordinates lower_{};
+    Coordinates upper_{};
+    bool isDegen_ = true;
+    // Degenerate triangle which segment is too short for valid Line.
+    bool isShort_ = false;
+
+    PackedTriangle() = default;
+    explicit PackedTriangle(const Triangle &);
+};
+
+static_assert(std::is_trivially_copyable_v<PackedTriangle>, "PackedTriangle should be trivially copyable");
+
+/* Triangles group in structure of arrays layout.
+
+   Each PackedTriangle field is stored in its own array, so checks of
+   many candidates stream only the fields they use. Pairs that pass
+   bounding box & plane side checks are tested with Triangle::crosses
+   on triangles copies stored apart from hot arrays.
+*/
+class TriangleSoup final
+{
+    // points_[pointId][coordId][trId]
+    std::array<std::array<std::vector<fp_t>, DNUM>, TR_POINT_NUM> points_{};
+    std::array<std::vector<fp_t>, DNUM> n_{};
+    std::vector<fp_t> D_{};
+    std::array<std::vector<fp_t>, DNUM> lower_{};
+    std::array<std::vector<fp_t>, DNUM> upper_{};
+    std::vector<char> isDegen_{};
+    std::vector<char> isShort_{};
+
+    // Cold data: used for pairs passed all checks only.
+    std::vector<Triangle> trs_{};
+    TrsIndexes indexes_{};
+
+  public:
+    TriangleSoup() = default;
+    explicit TriangleSoup(const IndexedTrsGroup &);
+
+    size_t size() const noexcept
+    {
+        return indexes_.size();
+    }
+
+    void reserve(size_t);
+    void push_back(const Triangle &, size_t index);
+
+    PackedTriangle packed(size_t trId) const;
+
+    const Triangle &triangle(size_t trId) const
+    {
+        return trs_[trId];
+    }
+
+    size_t index(size_t trId) const
+    {
+        return indexes_[trId];
+    }
+
+    // False only for triangles that Triangle::crosses never finds crossed:
+    // bounding boxes are separated or all points of one triangle lie on one
+    // side of the other triangle plane. Boxes are not checked for short &
+    // long segments pair: Triangle::crosses checks if long segment line
+    // (not segment itself) contains short segment point.
+    bool mayCross(const PackedTriangle &, size_t trId) const;
+
+    // Writes ids of triangles from [begin, end) that may cross given one to
+    // passedIds (should fit end - begin ids) & returns their number.
+    // The same as mayCross, but candidates are checked in SIMD batches
+    // of 8 (AVX2) or 4 (SSE) triangles.
+    size_t selectMayCross(const PackedTriangle &, size_t begin, size_t end, size_t *passedIds) const;
+
+    // The same result as triangle (ftId).crosses (sd.triangle (sdId)).
+    bool crosses(size_t ftId, const TriangleSoup &sd, size_t sdId) const;
+};
+
+// Brute force rows [rowsBegin, rowsEnd): marks soup triangles crossed with
+// triangles of greater soup ids in crossMask (of soup.size ()).
+void crossRows(const TriangleSoup &, size_t rowsBegin, size_t rowsEnd, std::vector<bool> &crossMask);
+
+// Returns intersecting trianlges indexes.
+TrsIndexes cross(const TriangleSoup &);
+TrsIndexes cross(const TriangleSoup &, const TriangleSoup &);
+
+} // namespace geom3D
+
+#endif // #ifndef GEOM3D_SOUP_HH_INCL
@@ -4,6 +4,8 @@
 #ifndef GEOM3D_SPLIT_HH_INCL
 #define GEOM3D_SPLIT_HH_INCL
 
+#include "geom3D-pool.hh"
+#include "geom3D-soup.hh"
 #include "geom3D.hh"
 
 namespace geom3D
@@ -142,6 +144,11 @@ class SplittedTrsGroup final
         IndexedTrsGroup borderTrs_{};
         // For leafs - contains this sub group space domain internal triangles.
         IndexedTrsGroup internalTrs_{};
+
+        // For leafs - the same triangles packed for cross.
+        // Leafs groups above are cleared then (except root one).
+        TriangleSoup borderSoup_{};
+        TriangleSoup internalSoup_{};
     };
 
     // Iterator used for passes on specified depth.
@@ -176,9 +183,13 @@ class SplittedTrsGroup final
 
     const size_t splitDepth_;
     SubGroup *root_ = nullptr;
+    // Max triangle index + 1.
+    size_t indexesNum_ = 0;
 
   public:
     SplittedTrsGroup(const IndexedTrsGroup &group, size_t targetGroupSize);
+    // The same, but leafs borders are calculated in parallel by pool workers.
+    SplittedTrsGroup(const IndexedTrsGroup &group, size_t targetGroupSize, ThreadPool &);
     ~SplittedTrsGroup();
 
     // Will implement later.
@@ -188,6 +199,9 @@ class SplittedTrsGroup final
     SplittedTrsGroup operator=(SplittedTrsGroup &&sd) = delete;
 
     TrsIndexes cross() const;
+    // The same, but crossed in parallel by pool workers: brute force rows
+    // in release build & leafs in debug one.
+    TrsIndexes cross(ThreadPool &) const;
 
   private:
     // Calc SplittedTrsGroup computational complexity related to
@@ -195,9 +209,11 @@ class SplittedTrsGroup final
     fp_t calcСomplexityRatio() const;
     // Methods for ctor.
     void splitGroups(const IndexedTrsGroup &group);
-    void calcBorders();
+    void calcBorders(ThreadPool &);
+    std::vector<SubGroup *> getLeafs() const;
     static void splitGroup(SubGroup *);
     static void caclBorder(SubGroup *);
+    static void packLeaf(SubGroup *);
 
   public:
     // Testing stuff - implemented in tests files.
@@ -378,7 +378,8 @@ class Line final : public GeomPrimitive
     bool contains(const Point &toCheck) const
     {
         return fpCmpW{(P_[X] - toCheck[X]) * dir_[Y]} == (P_[Y] - toCheck[Y]) * dir_[X] &&
-               fpCmpW{(P_[Y] - toCheck[Y]) * dir_[Z]} == (P_[Z] - toCheck[Z]) * dir_[Y];
+               fpCmpW{(P_[Y] - toCheck[Y]) * dir_[Z]} == (P_[Z] - toCheck[Z]) * dir_[Y] &&
+               fpCmpW{(P_[Z] - toCheck[Z]) * dir_[X]} == (P_[X] - toCheck[X]) * dir_[Z];
     }
 
     // Is this line parallel to the second line?
@@ -0,0 +1,364 @@
+
+#include "geom3D-bvh.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+namespace
+{
+
+// Boxes centers bins number for SAH split search.
+constexpr size_t SAH_BINS_NUM = 16;
+// Nodes pair check cost in candidates checks (they are cheap SIMD ones).
+constexpr fp_t SAH_TRAVERSAL_COST = 8;
+// Parallel cross splits nodes pairs till there are such tasks number per worker.
+constexpr size_t TASKS_PER_WORKER = 8;
+
+// Axis aligned box, default constructed box is empty.
+struct Box final
+{
+    Coordinates lower_{inf, inf, inf};
+    Coordinates upper_{-inf, -inf, -inf};
+
+    void extend(const Coordinates &lower, const Coordinates &upper)
+    {
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        {
+            lower_[coordId] = std::min(lower_[coordId], lower[coordId]);
+            upper_[coordId] = std::max(upper_[coordId], upper[coordId]);
+        }
+    }
+
+    void extend(const Box &sd)
+    {
+        extend(sd.lower_, sd.upper_);
+    }
+
+    // Half of surface area (SAH uses areas ratios only).
+    fp_t area() const
+    {
+        Coordinates size{};
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+            size[coordId] = upper_[coordId] - lower_[coordId];
+
+        return size[X] * size[Y] + size[Y] * size[Z] + size[Z] * size[X];
+    }
+};
+
+// Triangle bounding box used for tree build.
+struct BoxItem final
+{
+    Box box_{};
+    Coordinates center_{};
+    size_t trId_ = 0;
+};
+
+BoxItem makeBoxItem(const PackedTriangle &tr, size_t trId)
+{
+    BoxItem item{};
+    item.box_.extend(tr.lower_, tr.upper_);
+    item.trId_ = trId;
+
+    bool isFinite = true;
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        isFinite = isFinite && std::isfinite(tr.lower_[coordId]) && std::isfinite(tr.upper_[coordId]);
+
+    // Boxes of invalid triangles & short segments are not always checked by
+    // TriangleSoup::mayCross, so they are infinite here.
+    if (!isFinite || tr.isShort_)
+    {
+        item.box_ = Box{{-inf, -inf, -inf}, {inf, inf, inf}};
+        item.center_ = Coordinates{0, 0, 0};
+        return item;
+    }
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        item.center_[coordId] = (tr.lower_[coordId] + tr.upper_[coordId]) / 2;
+
+    return item;
+}
+
+size_t getBinId(fp_t center, fp_t lower, fp_t scale)
+{
+    return std::min(static_cast<size_t>((center - lower) * scale), SAH_BINS_NUM - 1);
+}
+
+// Reorders items & returns left part size, 0 if items should stay in one leaf.
+size_t splitItems(std::vector<BoxItem>::iterator first, std::vector<BoxItem>::iterator last, const Box &box,
+                  const Box &centers)
+{
+    size_t itemsNum = last - first;
+
+    // Costs are SAH ones multiplied by box area: leaf one is itemsNum * area.
+    fp_t area = box.area();
+    fp_t bestCost = itemsNum <= BVHTrsGroup::MAX_LEAF_SIZE ? itemsNum * area : inf;
+    size_t bestAxis = DNUM;
+    size_t bestBinId = 0;
+
+    for (size_t axis = 0; axis < DNUM; ++axis)
+    {
+        fp_t lower = centers.lower_[axis];
+        fp_t extent = centers.upper_[axis] - lower;
+        if (!(extent > 0))
+            continue;
+
+        fp_t scale = SAH_BINS_NUM / extent;
+        std::array<Box, SAH_BINS_NUM> bins{};
+        std::array<size_t, SAH_BINS_NUM> binsSizes{};
+
+        for (auto it = first; it != last; ++it)
+        {
+            size_t binId = getBinId(it->center_[axis], lower, scale);
+            bins[binId].extend(it->box_);
+            ++binsSizes[binId];
+        }
+
+        // rightCosts[binId] is cost of bins from binId to the last one.
+        std::array<fp_t, SAH_BINS_NUM> rightCosts{};
+        Box rightBox{};
+        size_t rightSize = 0;
+        for (size_t binId = SAH_BINS_NUM - 1; binId > 0; --binId)
+        {
+            rightBox.extend(bins[binId]);
+            rightSize += binsSizes[binId];
+            rightCosts[binId] = rightBox.area() * rightSize;
+        }
+
+        Box leftBox{};
+        size_t leftSize = 0;
+        for (size_t binId = 0; binId + 1 < SAH_BINS_NUM; ++binId)
+        {
+            leftBox.extend(bins[binId]);
+            leftSize += binsSizes[binId];
+
+            fp_t cost = SAH_TRAVERSAL_COST * area + leftBox.area() * leftSize + rightCosts[binId + 1];
+            if (leftSize != 0 && leftSize != itemsNum && cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBinId = binId;
+            }
+        }
+    }
+
+    if (bestAxis != DNUM)
+    {
+        fp_t lower = centers.lower_[bestAxis];
+        fp_t scale = SAH_BINS_NUM / (centers.upper_[bestAxis] - lower);
+
+        auto middle = std::partition(first, last, [=](const BoxItem &item) {
+            return getBinId(item.center_[bestAxis], lower, scale) <= bestBinId;
+        });
+        return middle - first;
+    }
+
+    if (itemsNum <= BVHTrsGroup::MAX_LEAF_SIZE)
+        return 0;
+
+    // No SAH split (e.g. all centers are the same): items are split in halves.
+    size_t axis = 0;
+    for (size_t coordId = 1; coordId < DNUM; ++coordId)
+        if (centers.upper_[coordId] - centers.lower_[coordId] > centers.upper_[axis] - centers.lower_[axis])
+            axis = coordId;
+
+    auto middle = first + itemsNum / 2;
+    std::nth_element(first, middle, last,
+                     [axis](const BoxItem &ft, const BoxItem &sd) { return ft.center_[axis] < sd.center_[axis]; });
+    return itemsNum / 2;
+}
+
+} // namespace
+
+BVHTrsGroup::BVHTrsGroup(const IndexedTrsGroup &group)
+{
+    size_t trNum = group.size();
+    if (trNum == 0)
+        return;
+
+    std::vector<BoxItem> items{};
+    items.reserve(trNum);
+    for (size_t trId = 0; trId < trNum; ++trId)
+        items.push_back(makeBoxItem(PackedTriangle{group[trId].first}, trId));
+
+    nodes_.reserve(2 * trNum);
+    nodes_.push_back(Node{{}, {}, 0, trNum});
+
+    // Nodes are split in depth first order, children are placed together.
+    std::vector<size_t> toSplitIds{0};
+    while (!toSplitIds.empty())
+    {
+        size_t nodeId = toSplitIds.back();
+        toSplitIds.pop_back();
+
+        size_t begin = nodes_[nodeId].begin_;
+        size_t end = nodes_[nodeId].end_;
+
+        Box box{};
+        Box centers{};
+        for (size_t itemId = begin; itemId < end; ++itemId)
+        {
+            box.extend(items[itemId].box_);
+            centers.extend(items[itemId].center_, items[itemId].center_);
+        }
+        nodes_[nodeId].lower_ = box.lower_;
+        nodes_[nodeId].upper_ = box.upper_;
+
+        size_t leftSize = splitItems(items.begin() + begin, items.begin() + end, box, centers);
+        if (leftSize == 0)
+            continue;
+
+        size_t leftId = nodes_.size();
+        nodes_.push_back(Node{{}, {}, begin, begin + leftSize});
+        nodes_.push_back(Node{{}, {}, begin + leftSize, end});
+        nodes_[nodeId].left_ = leftId;
+        nodes_[nodeId].right_ = leftId + 1;
+
+        toSplitIds.push_back(leftId);
+        toSplitIds.push_back(leftId + 1);
+    }
+
+    soup_.reserve(trNum);
+    for (const BoxItem &item : items)
+        soup_.push_back(group[item.trId_].first, group[item.trId_].second);
+}
+
+TrsIndexes BVHTrsGroup::cross() const
+{
+    ThreadPool pool{1};
+    return cross(pool);
+}
+
+TrsIndexes BVHTrsGroup::cross(ThreadPool &pool) const
+{
+    if (nodes_.empty())
+        return {};
+
+    // Pairs are split by levels till there are enough tasks for all workers.
+    std::vector<NodesPair> tasks{{0, 0}};
+    for (bool isSplit = true; isSplit && tasks.size() < pool.size() * TASKS_PER_WORKER && pool.size() > 1;)
+    {
+        std::vector<NodesPair> nextTasks{};
+        isSplit = false;
+
+        for (const NodesPair &pair : tasks)
+        {
+            if (pair.first != pair.second && !boxesCross(nodes_[pair.first], nodes_[pair.second]))
+                continue;
+
+            if (splitPair(pair, nextTasks))
+                isSplit = true;
+            else
+                nextTasks.push_back(pair);
+        }
+
+        tasks = std::move(nextTasks);
+    }
+
+    // Each worker marks crossed soup triangles in its own mask, masks are merged after run.
+    std::vector<std::vector<bool>> crossMasks(pool.size(), std::vector<bool>(soup_.size(), false));
+
+    pool.run(tasks.size(), [this, &tasks, &crossMasks](size_t taskId, size_t workerId) {
+        crossNodes(tasks[taskId], crossMasks[workerId]);
+    });
+
+    TrsIndexes ids{};
+    for (size_t trId = 0, trNum = soup_.size(); trId < trNum; ++trId)
+        if (std::any_of(crossMasks.begin(), crossMasks.end(),
+                        [trId](const std::vector<bool> &crossMask) { return crossMask[trId]; }))
+            ids.push_back(soup_.index(trId));
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+bool BVHTrsGroup::boxesCross(const Node &ft, const Node &sd) const
+{
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        if (ft.upper_[coordId] + BOX_PRECISION < sd.lower_[coordId] ||
+            sd.upper_[coordId] + BOX_PRECISION < ft.lower_[coordId])
+            return false;
+
+    return true;
+}
+
+void BVHTrsGroup::crossNodes(NodesPair startPair, std::vector<bool> &crossMask) const
+{
+    std::vector<NodesPair> pairs{startPair};
+
+    while (!pairs.empty())
+    {
+        NodesPair pair = pairs.back();
+        pairs.pop_back();
+
+        const Node &ft = nodes_[pair.first];
+        const Node &sd = nodes_[pair.second];
+        if (pair.first != pair.second && !boxesCross(ft, sd))
+            continue;
+
+        if (!splitPair(pair, pairs))
+            crossLeafs(ft, sd, crossMask);
+    }
+}
+
+void BVHTrsGroup::crossLeafs(const Node &ft, const Node &sd, std::vector<bool> &crossMask) const
+{
+    // Pairs are selected from lower index side only, so each pair of the same leaf is met once.
+    crossLeafsFrom(ft, sd, crossMask);
+    if (&ft != &sd)
+        crossLeafsFrom(sd, ft, crossMask);
+}
+
+void BVHTrsGroup::crossLeafsFrom(const Node &ft, const Node &sd, std::vector<bool> &crossMask) const
+{
+    std::array<size_t, MAX_LEAF_SIZE> passedIds{};
+
+    for (size_t ftId = ft.begin_; ftId < ft.end_; ++ftId)
+    {
+        PackedTriangle ftTr = soup_.packed(ftId);
+        size_t passedNum = soup_.selectMayCross(ftTr, sd.begin_, sd.end_, passedIds.data());
+
+        // Triangle::crosses & TriangleSoup::mayCross are not symmetric for some close to tolerance
+        // pairs, so pairs are selected & checked in group order as brute force cross does.
+        for (size_t k = 0; k < passedNum; ++k)
+            if (size_t sdId = passedIds[k];
+                soup_.index(ftId) < soup_.index(sdId) && soup_.triangle(ftId).crosses(soup_.triangle(sdId)))
+                crossMask[ftId] = crossMask[sdId] = true;
+    }
+}
+
+bool BVHTrsGroup::splitPair(NodesPair pair, std::vector<NodesPair> &pairs) const
+{
+    const Node &ft = nodes_[pair.first];
+    const Node &sd = nodes_[pair.second];
+
+    if (pair.first == pair.second)
+    {
+        if (ft.isLeaf())
+            return false;
+
+        pairs.emplace_back(ft.left_, ft.left_);
+        pairs.emplace_back(ft.right_, ft.right_);
+        pairs.emplace_back(ft.left_, ft.right_);
+        return true;
+    }
+
+    if (ft.isLeaf() && sd.isLeaf())
+        return false;
+
+    // Bigger node is descended.
+    if (sd.isLeaf() || (!ft.isLeaf() && ft.end_ - ft.begin_ >= sd.end_ - sd.begin_))
+    {
+        pairs.emplace_back(ft.left_, pair.second);
+        pairs.emplace_back(ft.right_, pair.second);
+    }
+    else
+    {
+        pairs.emplace_back(pair.first, sd.left_);
+        pairs.emplace_back(pair.first, sd.right_);
+    }
+
+    return true;
+}
+
+} // namespace geom3D
@@ -0,0 +1,428 @@
+
+#include "geom3D-dynamic.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+namespace
+{
+
+// Half of surface area of box containing both boxes.
+template <typename Box>
+fp_t unitedArea(const Box &ft, const Box &sd)
+{
+    Coordinates size{};
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        size[coordId] = std::max(ft.upper_[coordId], sd.upper_[coordId]) -
+                        std::min(ft.lower_[coordId], sd.lower_[coordId]);
+
+    return size[X] * size[Y] + size[Y] * size[Z] + size[Z] * size[X];
+}
+
+template <typename Box>
+fp_t area(const Box &box)
+{
+    return unitedArea(box, box);
+}
+
+// Infinite boxes centers are at origin.
+template <typename Box>
+fp_t center(const Box &box, size_t coordId)
+{
+    fp_t sum = box.lower_[coordId] + box.upper_[coordId];
+    return std::isfinite(sum) ? sum / 2 : 0;
+}
+
+template <typename Box>
+bool boxesCross(const Box &ft, const Box &sd)
+{
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        if (ft.upper_[coordId] + BOX_PRECISION < sd.lower_[coordId] ||
+            sd.upper_[coordId] + BOX_PRECISION < ft.lower_[coordId])
+            return false;
+
+    return true;
+}
+
+} // namespace
+
+DynamicTrsGroup::DynamicTrsGroup(const IndexedTrsGroup &group)
+{
+    entries_.reserve(group.size());
+    nodes_.reserve(2 * group.size());
+
+    std::vector<size_t> leafsIds{};
+    for (const auto &[tr, index] : group)
+    {
+        auto [it, isInserted] = entries_.try_emplace(index);
+        if (!isInserted)
+            continue;
+
+        Entry &entry = it->second;
+        entry.tr_ = tr;
+        entry.leafId_ = allocNode();
+        nodes_[entry.leafId_].index_ = index;
+        setLeafBox(entry);
+        leafsIds.push_back(entry.leafId_);
+    }
+
+    // Top down build gives tighter tree than one by one inserts.
+    if (!leafsIds.empty())
+        rootId_ = build(leafsIds.begin(), leafsIds.end());
+
+    // Each pair is found by both triangles, it is linked by the one with lower index.
+    std::vector<size_t> candidates{};
+    for (auto &[index, entry] : entries_)
+    {
+        candidates.clear();
+        query(nodes_[entry.leafId_], candidates);
+
+        for (size_t candidate : candidates)
+            if (candidate > index)
+                linkIfCrossed(index, entry, candidate);
+    }
+}
+
+bool DynamicTrsGroup::insert(const Triangle &tr, size_t index)
+{
+    auto [it, isInserted] = entries_.try_emplace(index);
+    if (!isInserted)
+        return false;
+
+    Entry &entry = it->second;
+    entry.tr_ = tr;
+    entry.leafId_ = allocNode();
+    nodes_[entry.leafId_].index_ = index;
+
+    setLeafBox(entry);
+    link(index, entry);
+    insertLeaf(entry.leafId_);
+    return true;
+}
+
+bool DynamicTrsGroup::remove(size_t index)
+{
+    auto it = entries_.find(index);
+    if (it == entries_.end())
+        return false;
+
+    unlink(index, it->second);
+    removeLeaf(it->second.leafId_);
+    freeNode(it->second.leafId_);
+    entries_.erase(it);
+    return true;
+}
+
+bool DynamicTrsGroup::move(size_t index, const Triangle &tr)
+{
+    auto it = entries_.find(index);
+    if (it == entries_.end())
+        return false;
+
+    Entry &entry = it->second;
+    unlink(index, entry);
+    removeLeaf(entry.leafId_);
+
+    entry.tr_ = tr;
+    setLeafBox(entry);
+    link(index, entry);
+    insertLeaf(entry.leafId_);
+    return true;
+}
+
+TrsIndexes DynamicTrsGroup::cross() const
+{
+    return TrsIndexes(crossedIndexes_.begin(), crossedIndexes_.end());
+}
+
+void DynamicTrsGroup::setLeafBox(const Entry &entry)
+{
+    PackedTriangle packed{entry.tr_};
+    Node &leaf = nodes_[entry.leafId_];
+    leaf.lower_ = packed.lower_;
+    leaf.upper_ = packed.upper_;
+
+    // Boxes of invalid triangles & short segments are not always checked by
+    // TriangleSoup::mayCross, so they are infinite here.
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        if (!std::isfinite(leaf.lower_[coordId]) || !std::isfinite(leaf.upper_[coordId]) || packed.isShort_)
+        {
+            leaf.lower_ = Coordinates{-inf, -inf, -inf};
+            leaf.upper_ = Coordinates{inf, inf, inf};
+            return;
+        }
+}
+
+// Entry leaf should be out of tree.
+void DynamicTrsGroup::link(size_t index, Entry &entry)
+{
+    std::vector<size_t> candidates{};
+    query(nodes_[entry.leafId_], candidates);
+
+    for (size_t candidate : candidates)
+        linkIfCrossed(index, entry, candidate);
+}
+
+void DynamicTrsGroup::linkIfCrossed(size_t index, Entry &entry, size_t otherIndex)
+{
+    Entry &other = entries_.find(otherIndex)->second;
+    bool isCrossed = index < otherIndex ? entry.tr_.crosses(other.tr_) : other.tr_.crosses(entry.tr_);
+    if (!isCrossed)
+        return;
+
+    entry.crossed_.push_back(otherIndex);
+    other.crossed_.push_back(index);
+    crossedIndexes_.insert(index);
+    crossedIndexes_.insert(otherIndex);
+}
+
+void DynamicTrsGroup::unlink(size_t index, Entry &entry)
+{
+    for (size_t crossed : entry.crossed_)
+    {
+        std::vector<size_t> &otherCrossed = entries_.find(crossed)->second.crossed_;
+        *std::find(otherCrossed.begin(), otherCrossed.end(), index) = otherCrossed.back();
+        otherCrossed.pop_back();
+
+        if (otherCrossed.empty())
+            crossedIndexes_.erase(crossed);
+    }
+
+    entry.crossed_.clear();
+    crossedIndexes_.erase(index);
+}
+
+size_t DynamicTrsGroup::allocNode()
+{
+    if (freeNodesIds_.empty())
+    {
+        nodes_.emplace_back();
+        return nodes_.size() - 1;
+    }
+
+    size_t nodeId = freeNodesIds_.back();
+    freeNodesIds_.pop_back();
+    nodes_[nodeId] = Node{};
+    return nodeId;
+}
+
+void DynamicTrsGroup::freeNode(size_t nodeId)
+{
+    freeNodesIds_.push_back(nodeId);
+}
+
+size_t DynamicTrsGroup::build(std::vector<size_t>::iterator first, std::vector<size_t>::iterator last)
+{
+    if (last - first == 1)
+        return *first;
+
+    // Leafs are split by median of boxes centers along the longest centers extent.
+    Coordinates lower{inf, inf, inf};
+    Coordinates upper{-inf, -inf, -inf};
+    for (auto it = first; it != last; ++it)
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        {
+            lower[coordId] = std::min(lower[coordId], center(nodes_[*it], coordId));
+            upper[coordId] = std::max(upper[coordId], center(nodes_[*it], coordId));
+        }
+
+    size_t axis = X;
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        if (upper[coordId] - lower[coordId] > upper[axis] - lower[axis])
+            axis = coordId;
+
+    auto middle = first + (last - first) / 2;
+    std::nth_element(first, middle, last, [this, axis](size_t ft, size_t sd) {
+        return center(nodes_[ft], axis) < center(nodes_[sd], axis);
+    });
+
+    size_t leftId = build(first, middle);
+    size_t rightId = build(middle, last);
+    size_t nodeId = allocNode();
+
+    nodes_[nodeId].left_ = leftId;
+    nodes_[nodeId].right_ = rightId;
+    nodes_[leftId].parent_ = nodeId;
+    nodes_[rightId].parent_ = nodeId;
+    refit(nodeId);
+    return nodeId;
+}
+
+void DynamicTrsGroup::insertLeaf(size_t leafId)
+{
+    if (rootId_ == NULL_NODE)
+    {
+        rootId_ = leafId;
+        nodes_[leafId].parent_ = NULL_NODE;
+        return;
+    }
+
+    // Descend to the sibling with the least cost of new parent & ancestors growth.
+    size_t siblingId = rootId_;
+    while (!nodes_[siblingId].isLeaf())
+    {
+        const Node &node = nodes_[siblingId];
+        const Node &leaf = nodes_[leafId];
+
+        fp_t unitedNodeArea = unitedArea(node, leaf);
+        fp_t cost = 2 * unitedNodeArea;
+        fp_t inheritanceCost = 2 * (unitedNodeArea - area(node));
+
+        auto childCost = [this, &leaf, inheritanceCost](size_t childId) {
+            const Node &child = nodes_[childId];
+            fp_t unitedChildArea = unitedArea(child, leaf);
+            return (child.isLeaf() ? unitedChildArea : unitedChildArea - area(child)) + inheritanceCost;
+        };
+
+        fp_t leftCost = childCost(node.left_);
+        fp_t rightCost = childCost(node.right_);
+
+        if (cost < leftCost && cost < rightCost)
+            break;
+
+        siblingId = leftCost < rightCost ? node.left_ : node.right_;
+    }
+
+    size_t oldParentId = nodes_[siblingId].parent_;
+    size_t parentId = allocNode();
+
+    Node &parent = nodes_[parentId];
+    parent.parent_ = oldParentId;
+    parent.left_ = siblingId;
+    parent.right_ = leafId;
+    nodes_[siblingId].parent_ = parentId;
+    nodes_[leafId].parent_ = parentId;
+
+    if (oldParentId == NULL_NODE)
+        rootId_ = parentId;
+    else if (nodes_[oldParentId].left_ == siblingId)
+        nodes_[oldParentId].left_ = parentId;
+    else
+        nodes_[oldParentId].right_ = parentId;
+
+    fixUpwards(parentId);
+}
+
+void DynamicTrsGroup::removeLeaf(size_t leafId)
+{
+    if (leafId == rootId_)
+    {
+        rootId_ = NULL_NODE;
+        return;
+    }
+
+    size_t parentId = nodes_[leafId].parent_;
+    size_t grandParentId = nodes_[parentId].parent_;
+    size_t siblingId = nodes_[parentId].left_ == leafId ? nodes_[parentId].right_ : nodes_[parentId].left_;
+
+    freeNode(parentId);
+    nodes_[siblingId].parent_ = grandParentId;
+
+    if (grandParentId == NULL_NODE)
+    {
+        rootId_ = siblingId;
+        return;
+    }
+
+    if (nodes_[grandParentId].left_ == parentId)
+        nodes_[grandParentId].left_ = siblingId;
+    else
+        nodes_[grandParentId].right_ = siblingId;
+
+    fixUpwards(grandParentId);
+}
+
+void DynamicTrsGroup::fixUpwards(size_t nodeId)
+{
+    while (nodeId != NULL_NODE)
+    {
+        nodeId = balance(nodeId);
+        refit(nodeId);
+        nodeId = nodes_[nodeId].parent_;
+    }
+}
+
+void DynamicTrsGroup::refit(size_t nodeId)
+{
+    Node &node = nodes_[nodeId];
+    const Node &left = nodes_[node.left_];
+    const Node &right = nodes_[node.right_];
+
+    node.height_ = 1 + std::max(left.height_, right.height_);
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        node.lower_[coordId] = std::min(left.lower_[coordId], right.lower_[coordId]);
+        node.upper_[coordId] = std::max(left.upper_[coordId], right.upper_[coordId]);
+    }
+}
+
+size_t DynamicTrsGroup::balance(size_t nodeId)
+{
+    // Node height isn't refitted yet, so only children ones are used.
+    Node &node = nodes_[nodeId];
+    if (node.isLeaf())
+        return nodeId;
+
+    size_t leftId = node.left_;
+    size_t rightId = node.right_;
+    size_t leftHeight = nodes_[leftId].height_;
+    size_t rightHeight = nodes_[rightId].height_;
+
+    if (leftHeight + 1 >= rightHeight && rightHeight + 1 >= leftHeight)
+        return nodeId;
+
+    // Higher child becomes subtree root, node takes its lower grandchild.
+    bool isRightHigher = rightHeight > leftHeight;
+    size_t upId = isRightHigher ? rightId : leftId;
+    Node &up = nodes_[upId];
+
+    size_t firstId = up.left_;
+    size_t secondId = up.right_;
+    size_t higherId = nodes_[firstId].height_ > nodes_[secondId].height_ ? firstId : secondId;
+    size_t lowerId = higherId == firstId ? secondId : firstId;
+
+    up.parent_ = node.parent_;
+    node.parent_ = upId;
+    if (up.parent_ == NULL_NODE)
+        rootId_ = upId;
+    else if (nodes_[up.parent_].left_ == nodeId)
+        nodes_[up.parent_].left_ = upId;
+    else
+        nodes_[up.parent_].right_ = upId;
+
+    up.left_ = nodeId;
+    up.right_ = higherId;
+    (isRightHigher ? node.right_ : node.left_) = lowerId;
+    nodes_[lowerId].parent_ = nodeId;
+
+    refit(nodeId);
+    refit(upId);
+    return upId;
+}
+
+void DynamicTrsGroup::query(const Node &box, std::vector<size_t> &indexes) const
+{
+    if (rootId_ == NULL_NODE)
+        return;
+
+    std::vector<size_t> stack{rootId_};
+    while (!stack.empty())
+    {
+        const Node &node = nodes_[stack.back()];
+        stack.pop_back();
+
+        if (!boxesCross(node, box))
+            continue;
+
+        if (node.isLeaf())
+            indexes.push_back(node.index_);
+        else
+        {
+            stack.push_back(node.left_);
+            stack.push_back(node.right_);
+        }
+    }
+}
+
+} // namespace geom3D
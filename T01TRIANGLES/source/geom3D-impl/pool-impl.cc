@@ -0,0 +1,111 @@
+
+#include "geom3D-pool.hh"
+
+namespace geom3D
+{
+
+ThreadPool::ThreadPool(size_t threadsNum)
+{
+    if (threadsNum == 0)
+        threadsNum = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (size_t i = 0; i < threadsNum; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+
+    // Worker 0 is calling thread.
+    for (size_t workerId = 1; workerId < threadsNum; ++workerId)
+        threads_.emplace_back(&ThreadPool::work, this, workerId);
+}
+
+ThreadPool::~ThreadPool()
+{
+    isStopped_ = true;
+    ++runId_;
+    runId_.notify_all();
+
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+void ThreadPool::run(size_t tasksNum, const std::function<void(size_t, size_t)> &job)
+{
+    size_t workersNum = size();
+
+    for (size_t workerId = 0; workerId < workersNum; ++workerId)
+    {
+        Worker &worker = *workers_[workerId];
+        std::lock_guard<std::mutex> lock{worker.mutex_};
+
+        for (size_t taskId = tasksNum * workerId / workersNum; taskId < tasksNum * (workerId + 1) / workersNum;
+             ++taskId)
+            worker.tasks_.push_back(taskId);
+    }
+
+    job_ = &job;
+    busyThreadsNum_ = threads_.size();
+    ++runId_;
+    runId_.notify_all();
+
+    runTasks(0);
+
+    for (size_t busyNum = busyThreadsNum_; busyNum != 0; busyNum = busyThreadsNum_)
+        busyThreadsNum_.wait(busyNum);
+    job_ = nullptr;
+}
+
+void ThreadPool::work(size_t workerId)
+{
+    size_t doneRunId = 0;
+
+    while (true)
+    {
+        runId_.wait(doneRunId);
+        if (isStopped_)
+            return;
+        doneRunId = runId_;
+
+        runTasks(workerId);
+
+        if (--busyThreadsNum_ == 0)
+            busyThreadsNum_.notify_one();
+    }
+}
+
+void ThreadPool::runTasks(size_t workerId)
+{
+    // Tasks are not added while running, so all deques are empty
+    // when worker can't pop nor steal.
+    for (size_t taskId = 0; popTask(workerId, taskId);)
+        (*job_)(taskId, workerId);
+}
+
+bool ThreadPool::popTask(size_t workerId, size_t &taskId)
+{
+    {
+        Worker &own = *workers_[workerId];
+        std::lock_guard<std::mutex> lock{own.mutex_};
+        if (!own.tasks_.empty())
+        {
+            taskId = own.tasks_.front();
+            own.tasks_.pop_front();
+            return true;
+        }
+    }
+
+    size_t workersNum = size();
+    for (size_t shift = 1; shift < workersNum; ++shift)
+    {
+        Worker &victim = *workers_[(workerId + shift) % workersNum];
+        std::lock_guard<std::mutex> lock{victim.mutex_};
+        if (!victim.tasks_.empty())
+        {
+            taskId = victim.tasks_.back();
+            victim.tasks_.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace geom3D
@@ -0,0 +1,461 @@
+
+#include <cstdint>
+#include <cstring>
+
+#include "geom3D-soup.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+PackedTriangle::PackedTriangle(const Triangle &tr)
+    : isDegen_(tr.isDegen()), isShort_(isDegen_ && !Line{tr.AB()}.isValid())
+{
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        P_[pointId] = tr[pointId];
+
+    Plane plane = tr.plane();
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        n_[coordId] = plane.n()[coordId];
+    D_ = plane.D();
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        lower_[coordId] = std::min({P_[0][coordId], P_[1][coordId], P_[2][coordId]});
+        upper_[coordId] = std::max({P_[0][coordId], P_[1][coordId], P_[2][coordId]});
+    }
+}
+
+TriangleSoup::TriangleSoup(const IndexedTrsGroup &group)
+{
+    reserve(group.size());
+
+    for (const auto &[tr, index] : group)
+        push_back(tr, index);
+}
+
+void TriangleSoup::reserve(size_t trNum)
+{
+    for (auto &point : points_)
+        for (auto &coords : point)
+            coords.reserve(trNum);
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        n_[coordId].reserve(trNum);
+        lower_[coordId].reserve(trNum);
+        upper_[coordId].reserve(trNum);
+    }
+
+    D_.reserve(trNum);
+    isDegen_.reserve(trNum);
+    isShort_.reserve(trNum);
+    trs_.reserve(trNum);
+    indexes_.reserve(trNum);
+}
+
+void TriangleSoup::push_back(const Triangle &tr, size_t index)
+{
+    PackedTriangle packedTr{tr};
+
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+            points_[pointId][coordId].push_back(packedTr.P_[pointId][coordId]);
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        n_[coordId].push_back(packedTr.n_[coordId]);
+        lower_[coordId].push_back(packedTr.lower_[coordId]);
+        upper_[coordId].push_back(packedTr.upper_[coordId]);
+    }
+
+    D_.push_back(packedTr.D_);
+    isDegen_.push_back(packedTr.isDegen_);
+    isShort_.push_back(packedTr.isShort_);
+    trs_.push_back(tr);
+    indexes_.push_back(index);
+}
+
+PackedTriangle TriangleSoup::packed(size_t trId) const
+{
+    PackedTriangle packedTr{};
+
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+            packedTr.P_[pointId][coordId] = points_[pointId][coordId][trId];
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        packedTr.n_[coordId] = n_[coordId][trId];
+        packedTr.lower_[coordId] = lower_[coordId][trId];
+        packedTr.upper_[coordId] = upper_[coordId][trId];
+    }
+
+    packedTr.D_ = D_[trId];
+    packedTr.isDegen_ = isDegen_[trId];
+    packedTr.isShort_ = isShort_[trId];
+
+    return packedTr;
+}
+
+namespace
+{
+
+// Is one of 3 points near the plane or are they on different sides?
+// Expression is the same as in Plane::eVal, so results are
+// the same as in Segment & Plane cross.
+template <class GetCoord> bool touchesPlane(const Coordinates &n, fp_t D, GetCoord getCoord)
+{
+    bool hasPositive = false;
+    bool hasNegative = false;
+
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+    {
+        fp_t eVal = n[X] * getCoord(pointId, X) + n[Y] * getCoord(pointId, Y) + n[Z] * getCoord(pointId, Z) + D;
+        if (fpCmpW{} == eVal)
+            return true;
+
+        (eVal > 0 ? hasPositive : hasNegative) = true;
+    }
+
+    return hasPositive && hasNegative;
+}
+
+} // namespace
+
+bool TriangleSoup::mayCross(const PackedTriangle &ft, size_t trId) const
+{
+    // Point of short segment is checked with the whole line of long one.
+    if (ft.isDegen_ && isDegen_[trId] && ft.isShort_ != bool(isShort_[trId]))
+        return true;
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        if (ft.upper_[coordId] + BOX_PRECISION < lower_[coordId][trId] ||
+            upper_[coordId][trId] + BOX_PRECISION < ft.lower_[coordId])
+            return false;
+
+    // Triangle::crosses checks crossing of degenerate triangle segment or
+    // the first triangle sides with not degenerate triangle plane.
+    if (!isDegen_[trId])
+    {
+        Coordinates n{n_[X][trId], n_[Y][trId], n_[Z][trId]};
+        return touchesPlane(n, D_[trId], [&ft](size_t pointId, size_t coordId) { return ft.P_[pointId][coordId]; });
+    }
+
+    if (!ft.isDegen_)
+        return touchesPlane(ft.n_, ft.D_, [this, trId](size_t pointId, size_t coordId) {
+            return points_[pointId][coordId][trId];
+        });
+
+    return true;
+}
+
+namespace
+{
+
+// TriangleSoup hot arrays.
+struct SoupArrays final
+{
+    std::array<std::array<const fp_t *, DNUM>, TR_POINT_NUM> P_{};
+    std::array<const fp_t *, DNUM> n_{};
+    const fp_t *D_ = nullptr;
+    std::array<const fp_t *, DNUM> lower_{};
+    std::array<const fp_t *, DNUM> upper_{};
+    const char *isDegen_ = nullptr;
+    const char *isShort_ = nullptr;
+};
+
+// Candidates batch & comparsions masks of WIDTH lanes
+// (vector_size attribute can't depend on template parameter).
+template <size_t WIDTH> struct Batch;
+
+template <> struct Batch<4>
+{
+    typedef fp_t Fps __attribute__((vector_size(4 * sizeof(fp_t))));
+    typedef std::int32_t Masks __attribute__((vector_size(4 * sizeof(std::int32_t))));
+};
+
+template <> struct Batch<8>
+{
+    typedef fp_t Fps __attribute__((vector_size(8 * sizeof(fp_t))));
+    typedef std::int32_t Masks __attribute__((vector_size(8 * sizeof(std::int32_t))));
+};
+
+static_assert(sizeof(fp_t) == sizeof(std::int32_t), "Comparsions masks should have fp_t lanes");
+
+// Checks of TriangleSoup::mayCross for batchesNum batches of WIDTH candidates from begin.
+// Lanes are checked without branches, expressions & comparsions are the same as
+// scalar ones (no FMA contractions), so results are the same too.
+// Inlined to functions with target ISA below: WIDTH should be its register width,
+// otherwise comparsions are done lane by lane.
+template <size_t WIDTH>
+__attribute__((always_inline)) inline size_t selectBatches(const PackedTriangle &ft, const SoupArrays &soup,
+                                                           size_t begin, size_t batchesNum, size_t *passedIds)
+{
+    using Fps = typename Batch<WIDTH>::Fps;
+    using Masks = typename Batch<WIDTH>::Masks;
+
+    // Unaligned lanes load to single (not array) variable, so it stays in register.
+    auto load = [](Fps &dest, const fp_t *src) { std::memcpy(&dest, src, sizeof(dest)); };
+
+    const Fps zero = Fps{};
+    const Fps precision = zero + fpCmpW<>::CMP_PRECISION;
+    const Fps negPrecision = zero - fpCmpW<>::CMP_PRECISION;
+    const Masks allOnes = Masks{} == 0;
+
+    size_t passedNum = 0;
+
+    for (size_t batchId = 0; batchId < batchesNum; ++batchId)
+    {
+        size_t first = begin + batchId * WIDTH;
+
+        Masks passed = allOnes;
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+        {
+            Fps lower{};
+            Fps upper{};
+            load(lower, soup.lower_[coordId] + first);
+            load(upper, soup.upper_[coordId] + first);
+            passed &= ~(ft.upper_[coordId] + BOX_PRECISION < lower) & ~(upper + BOX_PRECISION < ft.lower_[coordId]);
+        }
+
+        // Short & long segments pairs pass without boxes & planes checks.
+        Masks linePassed{};
+        if (ft.isDegen_)
+            for (size_t lane = 0; lane < WIDTH; ++lane)
+                linePassed[lane] =
+                    -std::int32_t(soup.isDegen_[first + lane] && ft.isShort_ != bool(soup.isShort_[first + lane]));
+
+        // Most batches are far from ft: plane tests are skipped for them.
+        bool anyPassed = false;
+        for (size_t lane = 0; lane < WIDTH; ++lane)
+            anyPassed |= (passed[lane] | linePassed[lane]) != 0;
+        if (!anyPassed)
+            continue;
+
+        // Sign tests of ft points with candidates planes.
+        Fps nX{};
+        Fps nY{};
+        Fps nZ{};
+        Fps D{};
+        load(nX, soup.n_[X] + first);
+        load(nY, soup.n_[Y] + first);
+        load(nZ, soup.n_[Z] + first);
+        load(D, soup.D_ + first);
+
+        Masks ftNear{};
+        Masks ftPositive{};
+        Masks ftNegative{};
+        for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        {
+            const Coordinates &P = ft.P_[pointId];
+            Fps eVal = nX * P[X] + nY * P[Y] + nZ * P[Z] + D;
+            Masks isNear = (eVal <= precision) & (eVal >= negPrecision);
+            Masks isPositive = eVal > zero;
+
+            ftNear |= isNear;
+            ftPositive |= isPositive & ~isNear;
+            ftNegative |= ~isPositive & ~isNear;
+        }
+        Masks ftTouches = ftNear | (ftPositive & ftNegative);
+
+        // Sign tests of candidates points with ft plane.
+        Masks candTouches = allOnes;
+        if (!ft.isDegen_)
+        {
+            Masks candNear{};
+            Masks candPositive{};
+            Masks candNegative{};
+            for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+            {
+                Fps PX{};
+                Fps PY{};
+                Fps PZ{};
+                load(PX, soup.P_[pointId][X] + first);
+                load(PY, soup.P_[pointId][Y] + first);
+                load(PZ, soup.P_[pointId][Z] + first);
+
+                Fps eVal = ft.n_[X] * PX + ft.n_[Y] * PY + ft.n_[Z] * PZ + ft.D_;
+                Masks isNear = (eVal <= precision) & (eVal >= negPrecision);
+                Masks isPositive = eVal > zero;
+
+                candNear |= isNear;
+                candPositive |= isPositive & ~isNear;
+                candNegative |= ~isPositive & ~isNear;
+            }
+            candTouches = candNear | (candPositive & candNegative);
+        }
+
+        Masks isDegen{};
+        for (size_t lane = 0; lane < WIDTH; ++lane)
+            isDegen[lane] = -std::int32_t(soup.isDegen_[first + lane] != 0);
+
+        passed &= (~isDegen & ftTouches) | (isDegen & candTouches);
+        passed |= linePassed;
+
+        // Branchless compaction: each id is written, but counted only if passed.
+        for (size_t lane = 0; lane < WIDTH; ++lane)
+        {
+            passedIds[passedNum] = first + lane;
+            passedNum += passed[lane] & 1;
+        }
+    }
+
+    return passedNum;
+}
+
+// Batches checks for each ISA: AVX2 & SSE which is always here on x86-64.
+// No AVX-512 one: GCC expands 16 lanes comparsions of inlined kernel piecewise.
+#if defined(__GNUC__) && defined(__x86_64__)
+__attribute__((target("avx2"))) size_t selectAvx2Batches(const PackedTriangle &ft, const SoupArrays &soup,
+                                                          size_t begin, size_t batchesNum, size_t *passedIds)
+{
+    return selectBatches<8>(ft, soup, begin, batchesNum, passedIds);
+}
+#endif
+
+size_t selectSseBatches(const PackedTriangle &ft, const SoupArrays &soup, size_t begin, size_t batchesNum,
+                        size_t *passedIds)
+{
+    return selectBatches<4>(ft, soup, begin, batchesNum, passedIds);
+}
+
+// Batches checks function & its batch width.
+struct BatchesSelector final
+{
+    size_t (*select_)(const PackedTriangle &, const SoupArrays &, size_t, size_t, size_t *) = selectSseBatches;
+    size_t width_ = 4;
+};
+
+// The widest ISA supported by CPU.
+BatchesSelector getBatchesSelector()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2"))
+        return {selectAvx2Batches, 8};
+#endif
+    return {};
+}
+
+} // namespace
+
+size_t TriangleSoup::selectMayCross(const PackedTriangle &ft, size_t begin, size_t end, size_t *passedIds) const
+{
+    assert(begin <= end && end <= size());
+
+    SoupArrays arrays{};
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+            arrays.P_[pointId][coordId] = points_[pointId][coordId].data();
+
+    for (size_t coordId = 0; coordId < DNUM; ++coordId)
+    {
+        arrays.n_[coordId] = n_[coordId].data();
+        arrays.lower_[coordId] = lower_[coordId].data();
+        arrays.upper_[coordId] = upper_[coordId].data();
+    }
+    arrays.D_ = D_.data();
+    arrays.isDegen_ = isDegen_.data();
+    arrays.isShort_ = isShort_.data();
+
+    static const BatchesSelector selector = getBatchesSelector();
+
+    size_t batchesNum = (end - begin) / selector.width_;
+    size_t passedNum = batchesNum == 0 ? 0 : selector.select_(ft, arrays, begin, batchesNum, passedIds);
+
+    // Tail is checked one by one.
+    for (size_t trId = begin + batchesNum * selector.width_; trId < end; ++trId)
+        if (mayCross(ft, trId))
+            passedIds[passedNum++] = trId;
+
+    return passedNum;
+}
+
+bool TriangleSoup::crosses(size_t ftId, const TriangleSoup &sd, size_t sdId) const
+{
+    return sd.mayCross(packed(ftId), sdId) && trs_[ftId].crosses(sd.trs_[sdId]);
+}
+
+namespace
+{
+// Candidates are selected by blocks, so passed ids buffer is small.
+constexpr size_t CANDIDATES_BLOCK_SIZE = 256;
+} // namespace
+
+void crossRows(const TriangleSoup &soup, size_t rowsBegin, size_t rowsEnd, std::vector<bool> &crossMask)
+{
+    size_t trNum = soup.size();
+
+    std::array<size_t, CANDIDATES_BLOCK_SIZE> passedIds{};
+
+    for (size_t i = rowsBegin; i < rowsEnd; ++i)
+    {
+        PackedTriangle ft = soup.packed(i);
+
+        for (size_t begin = i + 1; begin < trNum; begin += CANDIDATES_BLOCK_SIZE)
+        {
+            size_t end = std::min(begin + CANDIDATES_BLOCK_SIZE, trNum);
+            size_t passedNum = soup.selectMayCross(ft, begin, end, passedIds.data());
+
+            for (size_t k = 0; k < passedNum; ++k)
+                if (size_t j = passedIds[k]; soup.triangle(i).crosses(soup.triangle(j)))
+                    crossMask[i] = crossMask[j] = true;
+        }
+    }
+}
+
+TrsIndexes cross(const TriangleSoup &soup)
+{
+    size_t trNum = soup.size();
+
+    std::vector<bool> crossMask(trNum, false);
+    crossRows(soup, 0, trNum, crossMask);
+
+    TrsIndexes crossedIds{};
+
+    for (size_t i = 0; i < trNum; ++i)
+        if (crossMask[i])
+            crossedIds.emplace_back(soup.index(i));
+
+    return crossedIds;
+}
+
+TrsIndexes cross(const TriangleSoup &ft, const TriangleSoup &sd)
+{
+    size_t ftTrNum = ft.size();
+    size_t sdTrNum = sd.size();
+
+    std::vector<bool> ftCrossMask(ftTrNum, false);
+    std::vector<bool> sdCrossMask(sdTrNum, false);
+
+    std::array<size_t, CANDIDATES_BLOCK_SIZE> passedIds{};
+
+    for (size_t ftId = 0; ftId < ftTrNum; ++ftId)
+    {
+        PackedTriangle ftTr = ft.packed(ftId);
+
+        for (size_t begin = 0; begin < sdTrNum; begin += CANDIDATES_BLOCK_SIZE)
+        {
+            size_t end = std::min(begin + CANDIDATES_BLOCK_SIZE, sdTrNum);
+            size_t passedNum = sd.selectMayCross(ftTr, begin, end, passedIds.data());
+
+            for (size_t k = 0; k < passedNum; ++k)
+                if (size_t sdId = passedIds[k]; ft.triangle(ftId).crosses(sd.triangle(sdId)))
+                    ftCrossMask[ftId] = sdCrossMask[sdId] = true;
+        }
+    }
+
+    TrsIndexes crossedIds{};
+
+    for (size_t i = 0; i < ftTrNum; ++i)
+        if (ftCrossMask[i])
+            crossedIds.push_back(ft.index(i));
+
+    for (size_t i = 0; i < sdTrNum; ++i)
+        if (sdCrossMask[i])
+            crossedIds.push_back(sd.index(i));
+
+    return crossedIds;
+}
+
+} // namespace geom3D
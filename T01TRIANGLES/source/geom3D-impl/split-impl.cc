@@ -83,14 +83,39 @@ SpaceOctant PointSplitter::getOctant(const Triangle &tr) const
     return eighths[0];
 }
 
+namespace
+{
+// Octree depth for leafs of targetGroupsSize triangles.
+size_t calcSplitDepth(size_t trNum, size_t targetGroupsSize)
+{
+    return trNum <= targetGroupsSize ? size_t{0} : static_cast<size_t>(std::log2(trNum / targetGroupsSize) / 3 + 1);
+}
+
+// Parallel brute force task crosses such rows number. First rows are longer,
+// so tasks are small enough for workers to steal the rest.
+constexpr size_t CROSS_ROWS_BLOCK_SIZE = 16;
+} // namespace
+
 SplittedTrsGroup::SplittedTrsGroup(const IndexedTrsGroup &group, size_t targetGroupsSize)
-    : splitDepth_{group.size() <= targetGroupsSize
-                      ? size_t{0}
-                      : static_cast<size_t>(std::log2(group.size() / targetGroupsSize) / 3 + 1)}
+    : splitDepth_{calcSplitDepth(group.size(), targetGroupsSize)}
+{
+    ThreadPool pool{1};
+
+    for (const auto &[tr, index] : group)
+        indexesNum_ = std::max(indexesNum_, index + 1);
+
+    splitGroups(group);
+    calcBorders(pool);
+}
 
+SplittedTrsGroup::SplittedTrsGroup(const IndexedTrsGroup &group, size_t targetGroupsSize, ThreadPool &pool)
+    : splitDepth_{calcSplitDepth(group.size(), targetGroupsSize)}
 {
+    for (const auto &[tr, index] : group)
+        indexesNum_ = std::max(indexesNum_, index + 1);
+
     splitGroups(group);
-    calcBorders();
+    calcBorders(pool);
 }
 
 SplittedTrsGroup::~SplittedTrsGroup()
@@ -117,8 +142,8 @@ fp_t SplittedTrsGroup::calcСomplexityRatio() const
 
     for (DepthIter dIt{root_, splitDepth_}, end = DepthIter::end(); dIt != end; ++dIt)
     {
-        fp_t iSz = dIt.node_->internalTrs_.size();
-        fp_t bSz = dIt.node_->borderTrs_.size();
+        fp_t iSz = dIt.node_->internalSoup_.size();
+        fp_t bSz = dIt.node_->borderSoup_.size();
 
         splitCrossesNum += iSz * iSz + bSz * bSz + iSz * bSz;
     }
@@ -130,27 +155,76 @@ TrsIndexes SplittedTrsGroup::cross() const
 {
     TrsIndexes ids{};
 
+// Octree leafs result can differ from brute force one, so release build returns brute force result.
 // Removed in debug build for representative unit tests.
 #ifdef NDEBUG
-    if (calcСomplexityRatio() < 1)
-#endif
-        for (DepthIter dIt{root_, splitDepth_}, end = DepthIter::end(); dIt != end; ++dIt)
-        {
-            const IndexedTrsGroup &intr = dIt.node_->internalTrs_;
-            const IndexedTrsGroup &bord = dIt.node_->borderTrs_;
+    ids = geom3D::cross(TriangleSoup{root_->internalTrs_});
+#else
+    for (DepthIter dIt{root_, splitDepth_}, end = DepthIter::end(); dIt != end; ++dIt)
+    {
+        const TriangleSoup &intr = dIt.node_->internalSoup_;
+        const TriangleSoup &bord = dIt.node_->borderSoup_;
 
-            concatVectors(ids, geom3D::cross(intr));
-            concatVectors(ids, geom3D::cross(bord));
-            concatVectors(ids, geom3D::cross(intr, bord));
-        }
-#ifdef NDEBUG
-    ids = geom3D::cross(root_->internalTrs_);
+        concatVectors(ids, geom3D::cross(intr));
+        concatVectors(ids, geom3D::cross(bord));
+        concatVectors(ids, geom3D::cross(intr, bord));
+    }
 #endif
 
     removeRepeatsNSort(ids);
     return ids;
 }
 
+TrsIndexes SplittedTrsGroup::cross(ThreadPool &pool) const
+{
+// The same brute force result as cross () in release build: its rows are split between workers.
+#ifdef NDEBUG
+    TriangleSoup soup{root_->internalTrs_};
+    size_t trNum = soup.size();
+
+    // Each worker marks crossed soup triangles in its own mask, masks are merged after run.
+    std::vector<std::vector<bool>> crossMasks(pool.size(), std::vector<bool>(trNum, false));
+
+    size_t tasksNum = (trNum + CROSS_ROWS_BLOCK_SIZE - 1) / CROSS_ROWS_BLOCK_SIZE;
+    pool.run(tasksNum, [&soup, &crossMasks, trNum](size_t taskId, size_t workerId) {
+        size_t rowsBegin = taskId * CROSS_ROWS_BLOCK_SIZE;
+        crossRows(soup, rowsBegin, std::min(rowsBegin + CROSS_ROWS_BLOCK_SIZE, trNum), crossMasks[workerId]);
+    });
+
+    TrsIndexes ids{};
+    for (size_t trId = 0; trId < trNum; ++trId)
+        if (std::any_of(crossMasks.begin(), crossMasks.end(),
+                        [trId](const std::vector<bool> &crossMask) { return crossMask[trId]; }))
+            ids.push_back(soup.index(trId));
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+#else
+    std::vector<SubGroup *> leafs = getLeafs();
+
+    // Each worker marks crossed triangles in its own mask, masks are merged after run.
+    std::vector<std::vector<bool>> crossMasks(pool.size(), std::vector<bool>(indexesNum_, false));
+
+    pool.run(leafs.size(), [&leafs, &crossMasks](size_t leafId, size_t workerId) {
+        const TriangleSoup &intr = leafs[leafId]->internalSoup_;
+        const TriangleSoup &bord = leafs[leafId]->borderSoup_;
+        std::vector<bool> &crossMask = crossMasks[workerId];
+
+        for (const TrsIndexes &ids : {geom3D::cross(intr), geom3D::cross(bord), geom3D::cross(intr, bord)})
+            for (size_t index : ids)
+                crossMask[index] = true;
+    });
+
+    TrsIndexes ids{};
+    for (size_t index = 0; index < indexesNum_; ++index)
+        if (std::any_of(crossMasks.begin(), crossMasks.end(),
+                        [index](const std::vector<bool> &crossMask) { return crossMask[index]; }))
+            ids.push_back(index);
+
+    return ids;
+#endif
+}
+
 void SplittedTrsGroup::splitGroups(const IndexedTrsGroup &group)
 {
     root_ = new SubGroup;
@@ -164,12 +238,23 @@ void SplittedTrsGroup::splitGroups(const IndexedTrsGroup &group)
         }
 }
 
-void SplittedTrsGroup::calcBorders()
+void SplittedTrsGroup::calcBorders(ThreadPool &pool)
 {
+    // Leafs read borders of their parents only, so they are calculated independently.
+    std::vector<SubGroup *> leafs = getLeafs();
+    pool.run(leafs.size(), [&leafs](size_t leafId, size_t) { caclBorder(leafs[leafId]); });
+
+    // Leafs borders are not used by other leafs, so leafs are packed after all borders calculation.
+    pool.run(leafs.size(), [&leafs](size_t leafId, size_t) { packLeaf(leafs[leafId]); });
+}
+
+std::vector<SplittedTrsGroup::SubGroup *> SplittedTrsGroup::getLeafs() const
+{
+    std::vector<SubGroup *> leafs{};
     for (DepthIter dIt{root_, splitDepth_}, end = DepthIter::end(); dIt != end; ++dIt)
-    {
-        caclBorder(dIt.node_);
-    }
+        leafs.push_back(dIt.node_);
+
+    return leafs;
 }
 
 SplittedTrsGroup::DepthIter SplittedTrsGroup::DepthIter::operator++()
@@ -255,6 +340,20 @@ void SplittedTrsGroup::caclBorder(SubGroup *gr)
     }
 }
 
+void SplittedTrsGroup::packLeaf(SubGroup *leaf)
+{
+    leaf->borderSoup_ = TriangleSoup{leaf->borderTrs_};
+    leaf->internalSoup_ = TriangleSoup{leaf->internalTrs_};
+
+    leaf->borderTrs_.clear();
+    leaf->borderTrs_.shrink_to_fit();
+    if (leaf->parent_ != nullptr)
+    {
+        leaf->internalTrs_.clear();
+        leaf->internalTrs_.shrink_to_fit();
+    }
+}
+
 TrsIndexes cross(const IndexedTrsGroup &group)
 {
     size_t trNum = group.size();
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "geom3D-bvh.hh"
+#include "geom3D-gen.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+bool BVHTrsGroup::testTree(const IndexedTrsGroup &group)
+{
+    BVHTrsGroup bvh{group};
+
+    if (bvh.soup_.size() != group.size() || (group.empty() != bvh.nodes_.empty()))
+        return false;
+
+    // Soup is triangles permutation.
+    std::vector<bool> isMet(group.size(), false);
+    for (size_t trId = 0; trId < bvh.soup_.size(); ++trId)
+    {
+        size_t index = bvh.soup_.index(trId);
+        if (index >= group.size() || isMet[index])
+            return false;
+        isMet[index] = true;
+
+        for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+            if (!(bvh.soup_.triangle(trId)[pointId] == group[index].first[pointId]))
+                return false;
+    }
+
+    for (const Node &node : bvh.nodes_)
+    {
+        // Node box contains its triangles boxes.
+        for (size_t trId = node.begin_; trId < node.end_; ++trId)
+        {
+            PackedTriangle tr = bvh.soup_.packed(trId);
+            for (size_t coordId = 0; coordId < DNUM; ++coordId)
+                if (tr.lower_[coordId] < node.lower_[coordId] || tr.upper_[coordId] > node.upper_[coordId])
+                    return false;
+        }
+
+        if (node.isLeaf())
+        {
+            if (node.end_ - node.begin_ > MAX_LEAF_SIZE)
+                return false;
+            continue;
+        }
+
+        // Children split node range.
+        const Node &left = bvh.nodes_[node.left_];
+        const Node &right = bvh.nodes_[node.right_];
+        if (left.begin_ != node.begin_ || left.end_ != right.begin_ || right.end_ != node.end_ ||
+            left.begin_ == left.end_ || right.begin_ == right.end_)
+            return false;
+    }
+
+    return true;
+}
+
+namespace
+{
+// Small triangles scattered over space mixed with segments, points & few huge triangles.
+constexpr SceneParams SCENE_PARAMS{.isScattered = true, .hasHuge = true};
+} // namespace
+
+TEST(BVHTests, TreeTest)
+{
+    ASSERT_TRUE(BVHTrsGroup::testTree(IndexedTrsGroup{}));
+    ASSERT_TRUE(BVHTrsGroup::testTree(genSmallTrsGroup(1)));
+    ASSERT_TRUE(BVHTrsGroup::testTree(genSmallTrsGroup(500)));
+    ASSERT_TRUE(BVHTrsGroup::testTree(genSceneTrsGroup(2000, SCENE_PARAMS)));
+
+    // All boxes centers are the same.
+    IndexedTrsGroup sameGr{};
+    for (size_t i = 0; i < 100; ++i)
+        sameGr.push_back({Triangle{{1, 1, 1}, {2, 1, 1}, {1, 2, 1}}, i});
+    ASSERT_TRUE(BVHTrsGroup::testTree(sameGr));
+}
+
+TEST(BVHTests, CrossEquivTest)
+{
+    IndexedTrsGroup gr = genSceneTrsGroup(1500, SCENE_PARAMS);
+    TrsIndexes ids = cross(TriangleSoup{gr});
+    ASSERT_FALSE(ids.empty());
+
+    BVHTrsGroup bvh{gr};
+    ASSERT_EQ(bvh.cross(), ids);
+
+    for (size_t threadsNum : {2, 3, 8})
+    {
+        ThreadPool pool{threadsNum};
+        ASSERT_EQ(bvh.cross(pool), ids);
+    }
+
+    ASSERT_TRUE(BVHTrsGroup{IndexedTrsGroup{}}.cross().empty());
+}
+
+TEST(BVHTests, AsymmetricPairTest)
+{
+    // mayCross (packed (1), 0) is false, but triangle 0 crosses triangle 1, as brute force finds.
+    IndexedTrsGroup gr{
+        {Triangle{{-13.921611785888672, 22.826019287109375, 3.3778321743011475},
+                  {15.179571151733398, 11.196201324462891, 0.12809734046459198},
+                  {-2.5189225673675537, 6.5861101150512695, -30.351585388183594}},
+         0},
+        {Triangle{{-2.5778987407684326, -1.3539746999740601, 16.993583679199219},
+                  {1.76186203956604, 16.268638610839844, 0.82538086175918579},
+                  {4.9274773597717285, -5.9974284172058105, -14.692138671875}},
+         1}};
+
+    // Far triangles split the pair into different leafs.
+    for (size_t i = 2; i < 200; ++i)
+    {
+        Vector shift{static_cast<fp_t>(10 * i) - 1000, 0, 0};
+        gr.push_back({Triangle{Point{0, 0, 0} + shift, Point{1, 0, 0} + shift, Point{0, 1, 0} + shift}, i});
+    }
+
+    TrsIndexes ids = cross(TriangleSoup{gr});
+    ASSERT_EQ(ids, (TrsIndexes{0, 1}));
+    ASSERT_EQ(BVHTrsGroup{gr}.cross(), ids);
+}
+
+} // namespace geom3D
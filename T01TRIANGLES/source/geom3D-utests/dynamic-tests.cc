@@ -0,0 +1,176 @@
+#include <map>
+
+#include <gtest/gtest.h>
+
+#include "geom3D-dynamic.hh"
+#include "geom3D-gen.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+bool DynamicTrsGroup::testTree(const DynamicTrsGroup &group)
+{
+    if (group.rootId_ == NULL_NODE)
+        return group.entries_.empty();
+
+    if (group.nodes_[group.rootId_].parent_ != NULL_NODE)
+        return false;
+
+    size_t leafsNum = 0;
+    std::vector<size_t> stack{group.rootId_};
+    while (!stack.empty())
+    {
+        size_t nodeId = stack.back();
+        stack.pop_back();
+        const Node &node = group.nodes_[nodeId];
+
+        if (node.isLeaf())
+        {
+            auto it = group.entries_.find(node.index_);
+            if (node.height_ != 0 || it == group.entries_.end() || it->second.leafId_ != nodeId)
+                return false;
+
+            ++leafsNum;
+            continue;
+        }
+
+        const Node &left = group.nodes_[node.left_];
+        const Node &right = group.nodes_[node.right_];
+        if (left.parent_ != nodeId || right.parent_ != nodeId)
+            return false;
+
+        // Node height is refitted & its box contains children ones.
+        if (node.height_ != 1 + std::max(left.height_, right.height_))
+            return false;
+
+        for (size_t coordId = 0; coordId < DNUM; ++coordId)
+            for (const Node *child : {&left, &right})
+                if (child->lower_[coordId] < node.lower_[coordId] || child->upper_[coordId] > node.upper_[coordId])
+                    return false;
+
+        stack.push_back(node.left_);
+        stack.push_back(node.right_);
+    }
+
+    return leafsNum == group.entries_.size();
+}
+
+namespace
+{
+
+// Small triangles scattered over space mixed with segments, points & few huge triangles.
+constexpr SceneParams SCENE_PARAMS{.isScattered = true, .hasHuge = true};
+
+TrsIndexes bruteCross(const std::map<size_t, Triangle> &trs)
+{
+    IndexedTrsGroup gr{};
+    for (const auto &[index, tr] : trs)
+        gr.push_back({tr, index});
+
+    return cross(TriangleSoup{gr});
+}
+
+} // namespace
+
+TEST(DynamicTests, InterfaceTest)
+{
+    DynamicTrsGroup group{};
+    ASSERT_TRUE(DynamicTrsGroup::testTree(group));
+    ASSERT_TRUE(group.cross().empty());
+
+    Triangle tr{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    Triangle crossedTr{{0.2, 0.2, -1}, {0.2, 0.2, 1}, {0.3, 0.3, 1}};
+    Triangle farTr{{10, 10, 10}, {11, 10, 10}, {10, 11, 10}};
+
+    ASSERT_TRUE(group.insert(tr, 3));
+    ASSERT_FALSE(group.insert(farTr, 3));
+    ASSERT_TRUE(group.insert(crossedTr, 7));
+    ASSERT_EQ(group.size(), 2);
+    ASSERT_TRUE(group.contains(7));
+    ASSERT_EQ(group.cross(), (TrsIndexes{3, 7}));
+
+    ASSERT_TRUE(group.move(7, farTr));
+    ASSERT_TRUE(group.cross().empty());
+    ASSERT_TRUE(group.move(3, farTr));
+    ASSERT_EQ(group.cross(), (TrsIndexes{3, 7}));
+
+    ASSERT_TRUE(group.remove(3));
+    ASSERT_FALSE(group.remove(3));
+    ASSERT_FALSE(group.move(3, tr));
+    ASSERT_FALSE(group.contains(3));
+    ASSERT_TRUE(group.cross().empty());
+    ASSERT_TRUE(DynamicTrsGroup::testTree(group));
+
+    ASSERT_TRUE(group.remove(7));
+    ASSERT_EQ(group.size(), 0);
+    ASSERT_TRUE(DynamicTrsGroup::testTree(group));
+}
+
+TEST(DynamicTests, BuildEquivTest)
+{
+    std::map<size_t, Triangle> trs{};
+    IndexedTrsGroup gr{};
+    for (size_t i = 0; i < 1500; ++i)
+    {
+        trs.emplace(i, genSceneTr(i, SCENE_PARAMS));
+        gr.push_back({trs.at(i), i});
+    }
+
+    DynamicTrsGroup group{gr};
+    ASSERT_TRUE(DynamicTrsGroup::testTree(group));
+
+    TrsIndexes ids = group.cross();
+    ASSERT_FALSE(ids.empty());
+    ASSERT_EQ(ids, bruteCross(trs));
+}
+
+TEST(DynamicTests, UpdateEquivTest)
+{
+    constexpr size_t TRS_NUM = 600;
+    constexpr size_t FRAMES_NUM = 10;
+    constexpr size_t CHANGES_NUM = 60;
+
+    std::map<size_t, Triangle> trs{};
+    DynamicTrsGroup group{};
+    for (size_t i = 0; i < TRS_NUM; ++i)
+    {
+        trs.emplace(i, genSceneTr(i, SCENE_PARAMS));
+        ASSERT_TRUE(group.insert(trs.at(i), i));
+    }
+
+    // Each frame moves, removes & inserts random triangles.
+    size_t nextIndex = TRS_NUM;
+    for (size_t frame = 0; frame < FRAMES_NUM; ++frame)
+    {
+        for (size_t change = 0; change < CHANGES_NUM; ++change)
+        {
+            size_t index = static_cast<size_t>(std::rand()) % nextIndex;
+            bool isPresent = trs.find(index) != trs.end();
+            ASSERT_EQ(group.contains(index), isPresent);
+
+            if (!isPresent)
+            {
+                trs.emplace(nextIndex, genSceneTr(nextIndex, SCENE_PARAMS));
+                ASSERT_TRUE(group.insert(trs.at(nextIndex), nextIndex));
+                ++nextIndex;
+            }
+            else if (change % 4 == 0)
+            {
+                trs.erase(index);
+                ASSERT_TRUE(group.remove(index));
+            }
+            else
+            {
+                trs.insert_or_assign(index, genSceneTr(index, SCENE_PARAMS));
+                ASSERT_TRUE(group.move(index, trs.at(index)));
+            }
+        }
+
+        ASSERT_EQ(group.size(), trs.size());
+        ASSERT_TRUE(DynamicTrsGroup::testTree(group));
+        ASSERT_EQ(group.cross(), bruteCross(trs));
+    }
+}
+
+} // namespace geom3D
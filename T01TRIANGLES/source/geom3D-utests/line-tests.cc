@@ -54,6 +54,11 @@ TEST(LineTests, ContainsTest)
 
     ASSERT_TRUE(line.contains(p1) && line.contains(p1 + vec));
     ASSERT_FALSE(line.contains(p2));
+
+    // Direction with zero Y coordinate.
+    Line zLine{Vector{0, 0, 1}, Point{1, 1, 3}};
+    ASSERT_TRUE(zLine.contains(Point{1, 1, 0}));
+    ASSERT_FALSE(zLine.contains(Point{0, 1, 1}));
 }
 
 TEST(LineTests, parallelToTest)
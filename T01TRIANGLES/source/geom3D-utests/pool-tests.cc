@@ -0,0 +1,59 @@
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "geom3D-pool.hh"
+
+namespace geom3D
+{
+
+TEST(PoolTests, SizeTest)
+{
+    ASSERT_EQ(ThreadPool{1}.size(), 1);
+    ASSERT_EQ(ThreadPool{4}.size(), 4);
+    ASSERT_GE(ThreadPool{0}.size(), 1);
+}
+
+TEST(PoolTests, RunTest)
+{
+    ThreadPool pool{4};
+
+    // Each run calls each task once, ids of workers are valid.
+    for (size_t tasksNum : {0, 1, 3, 1000})
+    {
+        std::vector<std::atomic<size_t>> callsNums(tasksNum);
+        std::atomic<bool> isWorkerValid = true;
+
+        pool.run(tasksNum, [&](size_t taskId, size_t workerId) {
+            ++callsNums[taskId];
+            if (workerId >= pool.size())
+                isWorkerValid = false;
+        });
+
+        ASSERT_TRUE(isWorkerValid);
+        for (size_t taskId = 0; taskId < tasksNum; ++taskId)
+            ASSERT_EQ(callsNums[taskId], 1);
+    }
+}
+
+TEST(PoolTests, StealingTest)
+{
+    ThreadPool pool{2};
+
+    // Worker 0 gets first half of tasks and is blocked on the first one
+    // till all other tasks are done, so worker 1 should steal its tasks.
+    constexpr size_t TASKS_NUM = 10;
+    std::atomic<size_t> doneNum = 0;
+
+    pool.run(TASKS_NUM, [&doneNum](size_t taskId, size_t) {
+        if (taskId == 0)
+            while (doneNum != TASKS_NUM - 1)
+                std::this_thread::yield();
+
+        ++doneNum;
+    });
+
+    ASSERT_EQ(doneNum, TASKS_NUM);
+}
+
+} // namespace geom3D
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include "geom3D-gen.hh"
+#include "geom3D-soup.hh"
+#include "geom3D-split.hh"
+#include "geom3D.hh"
+
+namespace geom3D
+{
+
+namespace
+{
+
+// Checks that soup crosses exactly the same pairs as Triangle::crosses.
+void checkSoupCrosses(const std::vector<Triangle> &trs)
+{
+    IndexedTrsGroup gr{};
+    for (size_t i = 0; i < trs.size(); ++i)
+        gr.push_back({trs[i], i});
+    TriangleSoup soup{gr};
+
+    for (size_t i = 0; i < gr.size(); ++i)
+        for (size_t j = 0; j < gr.size(); ++j)
+        {
+            bool crosses = gr[i].first.crosses(gr[j].first);
+            ASSERT_EQ(soup.crosses(i, soup, j), crosses) << "pair " << i << ", " << j;
+            ASSERT_TRUE(!crosses || soup.mayCross(soup.packed(i), j)) << "pair " << i << ", " << j;
+        }
+
+    ASSERT_EQ(cross(gr), cross(soup));
+}
+
+} // namespace
+
+TEST(SoupTests, PackTest)
+{
+    Triangle tr{{1, 1, 1}, {5, 1, 1}, {3, 4, 2}};
+    TriangleSoup soup{};
+    soup.push_back(tr, 7);
+
+    PackedTriangle packed = soup.packed(0);
+
+    ASSERT_EQ(soup.size(), 1);
+    ASSERT_EQ(soup.index(0), 7);
+    ASSERT_FALSE(packed.isDegen_);
+    for (size_t pointId = 0; pointId < TR_POINT_NUM; ++pointId)
+        ASSERT_TRUE((Point{packed.P_[pointId][X], packed.P_[pointId][Y], packed.P_[pointId][Z]} == tr[pointId]));
+
+    ASSERT_TRUE((Point{packed.lower_[X], packed.lower_[Y], packed.lower_[Z]} == Point{1, 1, 1}));
+    ASSERT_TRUE((Point{packed.upper_[X], packed.upper_[Y], packed.upper_[Z]} == Point{5, 4, 2}));
+    ASSERT_TRUE((Vector{packed.n_[X], packed.n_[Y], packed.n_[Z]} == tr.plane().n()));
+}
+
+TEST(SoupTests, MayCrossTest)
+{
+    IndexedTrsGroup gr = genSceneTrsGroup(500);
+    TriangleSoup soup{gr};
+
+    size_t rejectedNum = 0;
+    for (size_t i = 0; i < gr.size(); ++i)
+    {
+        PackedTriangle ft = soup.packed(i);
+        for (size_t j = 0; j < gr.size(); ++j)
+        {
+            bool crosses = gr[i].first.crosses(gr[j].first);
+            ASSERT_EQ(soup.crosses(i, soup, j), crosses);
+
+            if (!soup.mayCross(ft, j))
+            {
+                ASSERT_FALSE(crosses);
+                ++rejectedNum;
+            }
+        }
+    }
+
+    // Checks are not useless.
+    ASSERT_NE(rejectedNum, 0);
+}
+
+TEST(SoupTests, SelectMayCrossTest)
+{
+    // Scale 0.001 gives short segments.
+    for (fp_t scale : {1.0, 0.001})
+    {
+        IndexedTrsGroup gr = genSceneTrsGroup(300, {.scale = scale});
+        TriangleSoup soup{gr};
+
+        std::vector<size_t> passedIds(gr.size());
+        for (size_t i = 0; i < gr.size(); ++i)
+        {
+            PackedTriangle ft = soup.packed(i);
+
+            // Ranges with & without SIMD batches tails.
+            size_t begin = i % 13;
+            size_t end = gr.size() - i % 7;
+            size_t passedNum = soup.selectMayCross(ft, begin, end, passedIds.data());
+
+            std::vector<size_t> expected{};
+            for (size_t j = begin; j < end; ++j)
+                if (soup.mayCross(ft, j))
+                    expected.push_back(j);
+
+            ASSERT_EQ(std::vector<size_t>(passedIds.begin(), passedIds.begin() + passedNum), expected);
+        }
+    }
+}
+
+TEST(SoupTests, ShortSegmentTest)
+{
+    // Short segment point lies on long segment line, but not in its box.
+    Triangle shortSeg{{-0.0479174, 0.0153490, 0.0659519}, {-0.0479795, 0.0162013, 0.066505},
+                      {-0.0479174, 0.0153490, 0.0659519}};
+    Triangle longSeg{{0.0072398, -0.0103594, -0.0000475}, {0.0084516, -0.0109381, -0.0015071},
+                     {0.0072398, -0.0103594, -0.0000475}};
+
+    IndexedTrsGroup gr{{shortSeg, 0}, {longSeg, 1}};
+    TriangleSoup soup{gr};
+
+    ASSERT_TRUE(soup.packed(0).isShort_);
+    ASSERT_FALSE(soup.packed(1).isShort_);
+    for (size_t i = 0; i < gr.size(); ++i)
+        for (size_t j = 0; j < gr.size(); ++j)
+        {
+            bool crosses = gr[i].first.crosses(gr[j].first);
+            ASSERT_EQ(soup.crosses(i, soup, j), crosses);
+            ASSERT_TRUE(!crosses || soup.mayCross(soup.packed(i), j));
+        }
+
+    ASSERT_EQ(cross(gr), cross(soup));
+}
+
+// Hand-written pairs from triangle tests: coplanar, touching & degenerate.
+TEST(SoupTests, HandWrittenPairsTest)
+{
+    // Segments & points.
+    checkSoupCrosses({{{1, 1, 1}, {2, 2, 2}, {3, 3, 3}},
+                      {{1, 1, 0}, {2, 2, 1}, {3, 3, 2}},
+                      {{1, 1, 0}, {3, 3, 0}, {2, 2, 0}},
+                      {{1, 1, 1}, {0, 0, 0}, {0, 0, 0}},
+                      {{1, 1, 1}, {2, 2, 1}, {3, 3, 1}},
+                      {{2, 1, 1}, {2, 3, 3}, {2, 3, 3}},
+                      {{2, 2, 2}, {2.5, 2.5, 2.5}, {2, 2, 2}},
+                      {{2, 2, 2}, {2, 2, 2}, {2, 2, 2}},
+                      {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}}});
+
+    // Triangle & segments.
+    checkSoupCrosses({{{1, 1, 1}, {1, 5, 1}, {5, 1, 1}},
+                      {{1, 1, 2}, {1, 1, 2}, {2, 2, 2}},
+                      {{1, 1, 5}, {1, 1, 3}, {1, 1, 4}},
+                      {{1, 1, 1}, {1, 1, 5}, {1, 1, 4}},
+                      {{1, 1, 4}, {3, 3, 0}, {3, 3, 0}},
+                      {{2, 2, 2}, {2, 2, 2}, {2, 2, 2}},
+                      {{2, 2, 1}, {2, 2, 1}, {2, 2, 1}},
+                      {{-1, -1, 1}, {-2, -2, 1}, {-3, -3, 1}},
+                      {{1, 1, 1}, {-1, -1, 1}, {1, 1, 1}},
+                      {{0, 2, 1}, {5, 0, 1}, {0, 1, 1}},
+                      {{0, 1, 1}, {6, 1, 1}, {0, 1, 1}}});
+
+    // Triangles.
+    checkSoupCrosses({{{1, 1, 1}, {5, 1, 1}, {3, 4, 1}},
+                      {{3, 1, -3}, {3, 1, 3}, {3, 4, 0}},
+                      {{-10, 5, 0}, {2, 3, 0}, {1, 6, 0}},
+                      {{1, 1, 1}, {2, 1, 1}, {1, 2, 1}},
+                      {{1, 1, 1}, {1, 0, 0}, {0, 1, 0}},
+                      {{1.1, 1.1, 1}, {2, 1.5, 1}, {1.5, 2, 1}},
+                      {{-1, -1, 1}, {2, -2, 1}, {-2, 2, 1}},
+                      {{2, 2, 4}, {5, 5, 4}, {4, 4, 1.5}}});
+}
+
+TEST(SoupTests, CrossEquivTest)
+{
+    IndexedTrsGroup gr = genSceneTrsGroup(700);
+    IndexedTrsGroup sd = genSceneTrsGroup(300);
+
+    ASSERT_EQ(cross(gr), cross(TriangleSoup{gr}));
+    ASSERT_EQ(cross(gr, sd), cross(TriangleSoup{gr}, TriangleSoup{sd}));
+
+    // Scenes with short segments.
+    for (fp_t scale : {0.01, 0.001})
+    {
+        IndexedTrsGroup smallGr = genSceneTrsGroup(400, {.scale = scale});
+        ASSERT_EQ(cross(smallGr), cross(TriangleSoup{smallGr}));
+    }
+}
+
+} // namespace geom3D
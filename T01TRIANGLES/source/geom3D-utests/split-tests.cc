@@ -83,4 +83,22 @@ TEST(SplittingTests, SplittingEquivTest)
     ASSERT_TRUE(fpCmpW{1} == ratio);
 }
 
+TEST(SplittingTests, ParallelSplittingEquivTest)
+{
+    IndexedTrsGroup gr = genSceneTrsGroup(3000, {.isScattered = true, .hasDegenerate = false});
+    SplittedTrsGroup spltGr(gr, 20);
+    TrsIndexes ids = spltGr.cross();
+    ASSERT_FALSE(ids.empty());
+
+    for (size_t threadsNum : {1, 2, 3, 8})
+    {
+        ThreadPool pool{threadsNum};
+        ASSERT_EQ(spltGr.cross(pool), ids);
+
+        // Pool is reused.
+        SplittedTrsGroup parallelSpltGr(gr, 20, pool);
+        ASSERT_EQ(parallelSpltGr.cross(pool), ids);
+    }
+}
+
 } // namespace geom3D
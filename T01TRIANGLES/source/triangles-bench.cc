@@ -0,0 +1,302 @@
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "geom3D-bvh.hh"
+#include "geom3D-dynamic.hh"
+#include "geom3D-soup.hh"
+#include "geom3D-split.hh"
+#include "geom3D.hh"
+
+namespace
+{
+
+// Reads triangles in triangles input format.
+geom3D::IndexedTrsGroup readTriangles(std::istream &in)
+{
+    size_t trNum = 0;
+    in >> trNum;
+
+    geom3D::IndexedTrsGroup triangles{};
+
+    for (size_t i = 0; i < trNum; ++i)
+    {
+        geom3D::Point pts[3] = {};
+        for (size_t j = 0; j < 3; ++j)
+        {
+            geom3D::fp_t coords[3] = {};
+            in >> coords[0] >> coords[1] >> coords[2];
+            pts[j] = geom3D::Point{coords[0], coords[1], coords[2]};
+        }
+
+        triangles.push_back({geom3D::Triangle{pts[0], pts[1], pts[2]}, i});
+    }
+
+    return triangles;
+}
+
+// Returns run time in ms.
+template <class Func> double measure(Func func)
+{
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Brute force N triangles cross on array of Triangle vs TriangleSoup.
+void benchSoup(const geom3D::IndexedTrsGroup &triangles, size_t trNum)
+{
+    geom3D::IndexedTrsGroup group{triangles.begin(), triangles.begin() + std::min(trNum, triangles.size())};
+    geom3D::TriangleSoup soup{group};
+
+    geom3D::TrsIndexes groupIds{};
+    geom3D::TrsIndexes soupIds{};
+    double groupTime = measure([&] { groupIds = geom3D::cross(group); });
+    double soupTime = measure([&] { soupIds = geom3D::cross(soup); });
+
+    std::cout << "brute force cross of " << group.size() << " triangles:" << std::endl;
+    std::cout << "    IndexedTrsGroup: " << groupTime << " ms, " << sizeof(group[0]) << " bytes per triangle"
+              << std::endl;
+    std::cout << "    TriangleSoup:    " << soupTime << " ms, " << 2 * geom3D::DNUM * sizeof(geom3D::fp_t)
+              << " bytes per rejected candidate" << std::endl;
+    std::cout << "    same result:     " << (groupIds == soupIds ? "yes" : "no") << std::endl;
+}
+
+// Octree split cross (release build crosses its root TriangleSoup by brute force).
+void benchSplit(const geom3D::IndexedTrsGroup &triangles)
+{
+    geom3D::TrsIndexes ids{};
+    double time = measure([&] {
+        geom3D::SplittedTrsGroup splTriangles{triangles, 20};
+        ids = splTriangles.cross();
+    });
+
+    std::cout << "octree split cross of " << triangles.size() << " triangles: " << time << " ms, " << ids.size()
+              << " crossed" << std::endl;
+}
+
+// Octree split cross with brute force rows processed by pool of threadsNum threads.
+void benchParallelSplit(const geom3D::IndexedTrsGroup &triangles, size_t threadsNum)
+{
+    geom3D::ThreadPool pool{threadsNum};
+
+    geom3D::TrsIndexes ids{};
+    double time = measure([&] {
+        geom3D::SplittedTrsGroup splTriangles{triangles, 20, pool};
+        ids = splTriangles.cross(pool);
+    });
+
+    std::cout << "octree split cross by " << pool.size() << " threads: " << time << " ms, " << ids.size()
+              << " crossed" << std::endl;
+}
+
+// BVH broad phase cross.
+geom3D::TrsIndexes benchBVH(const geom3D::IndexedTrsGroup &triangles)
+{
+    geom3D::TrsIndexes ids{};
+    size_t nodesNum = 0;
+    double time = measure([&] {
+        geom3D::BVHTrsGroup bvh{triangles};
+        ids = bvh.cross();
+        nodesNum = bvh.nodesNum();
+    });
+
+    std::cout << "bvh cross of " << triangles.size() << " triangles: " << time << " ms, " << ids.size()
+              << " crossed, " << nodesNum << " nodes" << std::endl;
+    return ids;
+}
+
+// Scenes are generated in genTr.py domain with fixed seed.
+constexpr geom3D::fp_t DOMAIN_SIZE = 12000;
+constexpr geom3D::fp_t TRS_SIZE = 100;
+
+// Triangle with points in [corner, corner + size) cube.
+geom3D::Triangle genTriangle(const geom3D::Coordinates &corner, geom3D::fp_t size, std::mt19937 &gen)
+{
+    std::uniform_real_distribution<geom3D::fp_t> dist{0, size};
+
+    geom3D::Point pts[3] = {};
+    for (size_t j = 0; j < 3; ++j)
+        pts[j] = geom3D::Point{corner[0] + dist(gen), corner[1] + dist(gen), corner[2] + dist(gen)};
+
+    return geom3D::Triangle{pts[0], pts[1], pts[2]};
+}
+
+geom3D::Coordinates genCorner(std::mt19937 &gen)
+{
+    std::uniform_real_distribution<geom3D::fp_t> dist{0, DOMAIN_SIZE};
+    return geom3D::Coordinates{dist(gen), dist(gen), dist(gen)};
+}
+
+// Small triangles uniformly placed in domain.
+geom3D::IndexedTrsGroup genUniformScene(size_t trNum, std::mt19937 &gen)
+{
+    geom3D::IndexedTrsGroup triangles{};
+    for (size_t i = 0; i < trNum; ++i)
+        triangles.push_back({genTriangle(genCorner(gen), TRS_SIZE, gen), i});
+
+    return triangles;
+}
+
+// Small triangles in few dense clusters.
+geom3D::IndexedTrsGroup genClusteredScene(size_t trNum, std::mt19937 &gen)
+{
+    constexpr size_t CLUSTERS_NUM = 8;
+    std::vector<geom3D::Coordinates> centers{};
+    for (size_t i = 0; i < CLUSTERS_NUM; ++i)
+        centers.push_back(genCorner(gen));
+
+    std::normal_distribution<geom3D::fp_t> dist{0, DOMAIN_SIZE / 50};
+
+    geom3D::IndexedTrsGroup triangles{};
+    for (size_t i = 0; i < trNum; ++i)
+    {
+        geom3D::Coordinates corner = centers[i % CLUSTERS_NUM];
+        for (size_t coordId = 0; coordId < geom3D::DNUM; ++coordId)
+            corner[coordId] += dist(gen);
+
+        triangles.push_back({genTriangle(corner, TRS_SIZE / 5, gen), i});
+    }
+
+    return triangles;
+}
+
+// Few triangles of domain size followed by uniform scene.
+geom3D::IndexedTrsGroup genHugeScene(size_t trNum, std::mt19937 &gen)
+{
+    constexpr size_t HUGE_TRS_NUM = 16;
+
+    geom3D::IndexedTrsGroup triangles{};
+    for (size_t i = 0; i < trNum; ++i)
+        triangles.push_back({genTriangle(i < HUGE_TRS_NUM ? geom3D::Coordinates{0, 0, 0} : genCorner(gen),
+                                         i < HUGE_TRS_NUM ? DOMAIN_SIZE : TRS_SIZE, gen),
+                             i});
+
+    return triangles;
+}
+
+// BVH broad phase vs brute force cross on generated scenes. Release octree split cross returns
+// brute force result, so brute force column stands for it too.
+void benchScenes(size_t trNum)
+{
+    std::mt19937 gen{};
+
+    std::pair<const char *, geom3D::IndexedTrsGroup> scenes[] = {
+        {"uniform", genUniformScene(trNum, gen)},
+        {"clustered", genClusteredScene(trNum, gen)},
+        {"few huge + many small", genHugeScene(trNum, gen)},
+    };
+
+    for (const auto &[name, triangles] : scenes)
+    {
+        geom3D::TrsIndexes bruteForceIds{};
+        double bruteForceTime = measure([&] { bruteForceIds = geom3D::cross(geom3D::TriangleSoup{triangles}); });
+        std::cout << name << " scene, " << bruteForceIds.size() << " crossed:" << std::endl;
+        std::cout << "    brute force: " << bruteForceTime << " ms" << std::endl;
+
+        geom3D::TrsIndexes bvhIds{};
+        double bvhTime = measure([&] { bvhIds = geom3D::BVHTrsGroup{triangles}.cross(); });
+        std::cout << "    bvh:         " << bvhTime << " ms, same as brute force: "
+                  << (bvhIds == bruteForceIds ? "yes" : "no") << std::endl;
+    }
+}
+
+// Frames of movedNum moved triangles in uniform scene: dynamic group update vs BVH rebuild.
+void benchDynamic(size_t trNum, size_t movedNum)
+{
+    constexpr size_t FRAMES_NUM = 20;
+    constexpr geom3D::fp_t MAX_STEP = TRS_SIZE / 2;
+
+    std::mt19937 gen{};
+    std::vector<geom3D::Coordinates> corners{};
+    geom3D::IndexedTrsGroup triangles{};
+    for (size_t i = 0; i < trNum; ++i)
+    {
+        corners.push_back(genCorner(gen));
+        triangles.push_back({genTriangle(corners.back(), TRS_SIZE, gen), i});
+    }
+
+    geom3D::DynamicTrsGroup group{};
+    double buildTime = measure([&] { group = geom3D::DynamicTrsGroup{triangles}; });
+
+    std::uniform_int_distribution<size_t> indexDist{0, trNum - 1};
+    std::uniform_real_distribution<geom3D::fp_t> stepDist{-MAX_STEP, MAX_STEP};
+
+    double framesTime = 0;
+    std::vector<size_t> movedIndexes{};
+    for (size_t frame = 0; frame < FRAMES_NUM; ++frame)
+    {
+        movedIndexes.clear();
+        for (size_t i = 0; i < movedNum; ++i)
+        {
+            size_t index = indexDist(gen);
+            for (size_t coordId = 0; coordId < geom3D::DNUM; ++coordId)
+                corners[index][coordId] += stepDist(gen);
+
+            triangles[index].first = genTriangle(corners[index], TRS_SIZE, gen);
+            movedIndexes.push_back(index);
+        }
+
+        framesTime += measure([&] {
+            for (size_t index : movedIndexes)
+                group.move(index, triangles[index].first);
+        });
+    }
+
+    geom3D::TrsIndexes bvhIds{};
+    double bvhTime = measure([&] { bvhIds = geom3D::BVHTrsGroup{triangles}.cross(); });
+
+    std::cout << "dynamic group of " << trNum << " triangles, " << movedNum << " moved per frame:" << std::endl;
+    std::cout << "    build:       " << buildTime << " ms" << std::endl;
+    std::cout << "    frame:       " << framesTime / FRAMES_NUM << " ms" << std::endl;
+    std::cout << "    bvh rebuild: " << bvhTime << " ms, same result: " << (group.cross() == bvhIds ? "yes" : "no")
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    static const char USAGE[] = "Usage: triangles-bench [BRUTE FORCE TRIANGLES NUM] [THREADS NUM] < <TRIANGLES FILE>\n"
+                                "       triangles-bench scenes [TRIANGLES NUM]\n"
+                                "       triangles-bench dynamic [TRIANGLES NUM] [MOVED NUM]\n"
+                                "    Triangles file format is triangles input one (see genTr.py).\n"
+                                "    Brute force cross uses first triangles of file (3000 by default).\n"
+                                "    Parallel split cross uses THREADS NUM threads (hardware threads by default).\n"
+                                "    scenes compares brute force & bvh on uniform, clustered and few huge + many small\n"
+                                "    triangles scenes (20000 triangles by default).\n"
+                                "    dynamic moves MOVED NUM (300 by default) of TRIANGLES NUM (500000 by default)\n"
+                                "    triangles per frame and compares dynamic group update with bvh rebuild.\n";
+
+    if (argc > 1 && (!std::strcmp(argv[1], "-h") || !std::strcmp(argv[1], "--help")))
+    {
+        std::cout << USAGE;
+        return 0;
+    }
+
+    if (argc > 1 && !std::strcmp(argv[1], "scenes"))
+    {
+        benchScenes(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000);
+        return 0;
+    }
+
+    if (argc > 1 && !std::strcmp(argv[1], "dynamic"))
+    {
+        benchDynamic(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500000,
+                     argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 300);
+        return 0;
+    }
+
+    size_t bruteForceNum = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000;
+    size_t threadsNum = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    geom3D::IndexedTrsGroup triangles = readTriangles(std::cin);
+
+    benchSoup(triangles, bruteForceNum);
+    benchSplit(triangles);
+    benchParallelSplit(triangles, threadsNum);
+    benchBVH(triangles);
+}
@@ -1,9 +1,60 @@
 
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "geom3D-bvh.hh"
 #include "geom3D-split.hh"
 #include "geom3D.hh"
 
-int main()
+namespace
+{
+
+// Accepts decimal digits only, so options aren't taken for threads number.
+bool parseThreadsNum(const char *arg, size_t &threadsNum)
 {
+    if (!std::isdigit(static_cast<unsigned char>(arg[0])))
+        return false;
+
+    char *end = nullptr;
+    threadsNum = std::strtoull(arg, &end, 10);
+    return *end == '\0';
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    static const char USAGE[] = "Usage: triangles [THREADS NUM] [--bvh | --octree] < <TRIANGLES FILE>\n"
+                                "    Broad phase is bvh (default) or octree (its result can differ from brute force one).\n"
+                                "    It is run by THREADS NUM threads (1 by default, 0 for hardware threads number).\n";
+
+    size_t threadsNum = 1;
+    bool isThreadsNumSet = false;
+    bool useOctree = false;
+
+    for (int argId = 1; argId < argc; ++argId)
+    {
+        const char *arg = argv[argId];
+
+        if (!std::strcmp(arg, "-h") || !std::strcmp(arg, "--help"))
+        {
+            std::cout << USAGE;
+            return 0;
+        }
+        else if (!std::strcmp(arg, "--octree"))
+            useOctree = true;
+        else if (!std::strcmp(arg, "--bvh"))
+            useOctree = false;
+        else if (!isThreadsNumSet && parseThreadsNum(arg, threadsNum))
+            isThreadsNumSet = true;
+        else
+        {
+            std::cout << USAGE;
+            return 1;
+        }
+    }
+
     size_t trNum = 0;
     std::cin >> trNum;
 
@@ -23,8 +74,12 @@ int main()
     }
 
 #if 1
-    geom3D::SplittedTrsGroup splTriangles{triangles, 20};
-    geom3D::TrsIndexes crossIds = splTriangles.cross();
+    geom3D::ThreadPool pool{threadsNum};
+    geom3D::TrsIndexes crossIds{};
+    if (useOctree)
+        crossIds = geom3D::SplittedTrsGroup{triangles, 20, pool}.cross(pool);
+    else
+        crossIds = geom3D::BVHTrsGroup{triangles}.cross(pool);
 #else
     geom3D::TrsIndexes crossIds = geom3D::cross(triangles);
 #endif